@@ -1,22 +1,58 @@
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
 
+#include <cstddef>
 #include <iostream>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <mtl/type_traits.h>
 
 namespace mtl {
+    typedef std::size_t size_t;
+
     /*  count how many elements between two iterators
-        type: Iterator, which must provides ++ and != operators */
+        type: Iterator, which must provides ++ and != operators
+        the random access iterators are subtracted instead of walked */
     template <typename Iterator>
     size_t count_length(Iterator begin, Iterator end);
 
-    /* type Iterator: this type should overload +, -, ++, --, ==, != and * operators, 
-       operator*() is used to dereference and return type is T&  */
+    /* type Iterator: this type should overload ++, --, ==, != and * operators, 
+       operator*() is used to dereference and return type is T&
+       the iterators tagged as random access by std::iterator_traits (see is_random_access_iterator)
+       are measured and advanced by - and + in O(1), the others are walked step by step */
 
     /* sort the array in place in ascending order (it will change the array directly)
-       the ranges is [begin, end) */
+       the ranges is [begin, end)
+       the random access ranges are sorted by introsort: quicksort with a median-of-three (ninther for the large
+       ranges) pivot, insertion sort for the partitions of at most 16 elements, and heapsort once the recursion
+       is deeper than 2 * log2(n), so it takes O(n log n) even on the sorted input. Only the smaller partition
+       is recursed into, the larger one is sorted by the loop, so the stack holds at most log2(n) frames.
+       the other ranges are sorted by the plain quicksort with the first element as the pivot */
     template <typename Iterator>
     void inplace_quicksort(Iterator begin, Iterator end);
 
+    /* sort [begin, end) in ascending order by insertion sort, it's fast for the short or almost sorted ranges */
+    template <typename Iterator>
+    void insertion_sort(Iterator begin, Iterator end);
+
+    /* sort the random access range [begin, end) in ascending order by heapsort in O(n log n) */
+    template <typename Iterator>
+    void heapsort(Iterator begin, Iterator end);
+
+    /* sort the random access range [begin, end) in ascending order by pattern-defeating quicksort (pdqsort)
+       it's an introsort which also
+       - gives up partitioning a range which is found already partitioned once insertion sort has fixed a few
+         elements, so the sorted, reverse sorted and the other runs take about O(n)
+       - puts the elements equal to the pivot together when the pivot equals the one before the range, so the
+         ranges of few distinct keys take O(n)
+       - shuffles a few elements after a highly unbalanced partition, and falls back to heapsort after log2(n) of them
+       - partitions the arithmetic elements by blocks (BlockQuicksort): the comparisons of a block are recorded
+         as offsets without branches, then the misplaced elements are swapped, so the branch mispredictions
+         don't depend on the data */
+    template <typename Iterator>
+    void pdqsort(Iterator begin, Iterator end);
+
     /* perform partition for the sequence in range [begin, end)
        all the elements smaller than the pivot are in the left side and thus the ones greater in the right side.
        return the iterator to the first element of the second group (the pivot) */
@@ -32,8 +68,8 @@ namespace mtl {
     template <typename Iterator>
     void inplace_merge(Iterator begin, Iterator mid, Iterator end) noexcept;
 
-    /* find the middle point of a sequence by fast and slow pointers 
-       if there are even numbers of elements, the smaller one will be returned */
+    /* find the middle point of a sequence by fast and slow pointers, or by begin + length / 2 for random access
+       if there are even numbers of elements, the latter one will be returned */
     template <typename Iterator>
     Iterator find_mid(Iterator begin, Iterator end);
 
@@ -57,25 +93,532 @@ namespace mtl {
 
     template <typename Iterator>
     size_t count_length(Iterator begin, Iterator end) {
-        size_t len = 0;
-        while (begin != end) {
-            ++begin;
-            ++len;
+        if constexpr (is_random_access_iterator_v<Iterator>) {
+            return static_cast<size_t>(end - begin);
+        } else {
+            size_t len = 0;
+            while (begin != end) {
+                ++begin;
+                ++len;
+            }
+
+            return len;
+        }
+    }
+
+    // the partitions not longer than it are left to insertion sort
+    inline constexpr std::ptrdiff_t introsort_threshold = 16;
+
+    // the largest k where 2^k <= n, n should be positive
+    inline size_t floor_log2(size_t n) {
+        size_t k = 0;
+        while (n >>= 1) {
+            ++k;
+        }
+        return k;
+    }
+
+    // the iterator to the median of *a, *b and *c
+    template <typename Iterator>
+    Iterator median_of_three(Iterator a, Iterator b, Iterator c) {
+        if (*a < *b) {
+            if (*b < *c) {
+                return b;
+            }
+            return *a < *c ? c : a;
+        }
+        if (*a < *c) {
+            return a;
+        }
+        return *b < *c ? c : b;
+    }
+
+    /* partition [first, last) around *pivot, which is outside the range, and return the start of the second part
+       the scans aren't bounded, so there must be an element not less than the pivot in the range */
+    template <typename Iterator>
+    Iterator unguarded_partition(Iterator first, Iterator last, Iterator pivot) {
+        while (true) {
+            while (*first < *pivot) {
+                ++first;
+            }
+            --last;
+            while (*pivot < *last) {
+                --last;
+            }
+            if (!(first < last)) {
+                return first;
+            }
+            mtl::swap(*first, *last);
+            ++first;
         }
+    }
+
+    template <typename Iterator>
+    void introsort_loop(Iterator begin, Iterator end, size_t depth) {
+        while (end - begin > introsort_threshold) {
+            if (depth == 0) {
+                mtl::heapsort(begin, end);
+                return;
+            }
+            --depth;
 
-        return len;
+            // the median of 3, or of the medians of 3 groups of 3 for the large ranges, is swapped to the front
+            auto len = end - begin;
+            auto mid = begin + len / 2;
+            Iterator pivot;
+            if (len > 128) {
+                auto step = len / 8;
+                pivot = mtl::median_of_three(mtl::median_of_three(begin + 1, begin + step, begin + 2 * step),
+                                        mtl::median_of_three(mid - step, mid, mid + step),
+                                        mtl::median_of_three(end - 1 - 2 * step, end - 1 - step, end - 1));
+            } else {
+                pivot = mtl::median_of_three(begin + 1, mid, end - 1);
+            }
+            mtl::swap(*begin, *pivot);
+            auto cut = mtl::unguarded_partition(begin + 1, end, begin);
+
+            // recurse into the smaller part and loop on the larger one
+            if (cut - begin < end - cut) {
+                mtl::introsort_loop(begin, cut, depth);
+                begin = cut;
+            } else {
+                mtl::introsort_loop(cut, end, depth);
+                end = cut;
+            }
+        }
+        mtl::insertion_sort(begin, end);
     }
 
     template <typename Iterator>
     void inplace_quicksort(Iterator begin, Iterator end) {
-        if (begin != end) {
-            auto mid = partition(begin, end);
-            inplace_quicksort(begin, mid);
-            ++mid;
-            inplace_quicksort(mid, end);
+        if constexpr (is_random_access_iterator_v<Iterator>) {
+            if (end - begin > 1) {
+                mtl::introsort_loop(begin, end, 2 * mtl::floor_log2(static_cast<size_t>(end - begin)));
+            }
+        } else {
+            if (begin != end) {
+                auto mid = mtl::partition(begin, end);
+                mtl::inplace_quicksort(begin, mid);
+                ++mid;
+                mtl::inplace_quicksort(mid, end);
+            }
+        }
+    }
+
+    template <typename Iterator>
+    void insertion_sort(Iterator begin, Iterator end) {
+        if (begin == end) {
+            return;
+        }
+        auto itr = begin;
+        for (++itr; itr != end; ++itr) {
+            auto elem = std::move(*itr);
+            auto hole = itr;
+            auto prev = itr;
+            while (hole != begin && elem < *--prev) {
+                *hole = std::move(*prev);
+                hole = prev;
+            }
+            *hole = std::move(elem);
+        }
+    }
+
+    // restore the max-heap [begin, begin + len) below the hole at index, which is filled with elem at last
+    template <typename Iterator, typename T>
+    void sift_down(Iterator begin, std::ptrdiff_t len, std::ptrdiff_t index, T elem) {
+        while (2 * index + 1 < len) {
+            auto child = 2 * index + 1;
+            if (child + 1 < len && begin[child] < begin[child + 1]) {
+                ++child;
+            }
+            if (!(elem < begin[child])) {
+                break;
+            }
+            begin[index] = std::move(begin[child]);
+            index = child;
+        }
+        begin[index] = std::move(elem);
+    }
+
+    template <typename Iterator>
+    void heapsort(Iterator begin, Iterator end) {
+        std::ptrdiff_t len = end - begin;
+        for (auto i = len / 2; i > 0; --i) {
+            mtl::sift_down(begin, len, i - 1, std::move(begin[i - 1]));
+        }
+        // move the max behind the heap one by one
+        for (auto n = len - 1; n > 0; --n) {
+            auto elem = std::move(begin[n]);
+            begin[n] = std::move(begin[0]);
+            mtl::sift_down(begin, n, 0, std::move(elem));
+        }
+    }
+
+    // the ranges shorter than it are left to insertion sort by pdqsort
+    inline constexpr std::ptrdiff_t pdq_insertion_threshold = 24;
+
+    // the ranges longer than it take the pivot by ninther
+    inline constexpr std::ptrdiff_t pdq_ninther_threshold = 128;
+
+    // partial insertion sort gives up after moving the elements this many places in total
+    inline constexpr std::ptrdiff_t pdq_partial_insertion_limit = 8;
+
+    // the number of elements compared in a block of the branchless partition, the offsets fit in unsigned char
+    inline constexpr std::ptrdiff_t pdq_block_size = 64;
+
+    /* insertion sort [begin, end) without checking the start of the range,
+       the element before begin must not be greater than any one in the range */
+    template <typename Iterator>
+    void unguarded_insertion_sort(Iterator begin, Iterator end) {
+        if (begin == end) {
+            return;
+        }
+        for (auto itr = begin + 1; itr != end; ++itr) {
+            auto prev = itr - 1;
+            if (*itr < *prev) {
+                auto elem = std::move(*itr);
+                auto hole = itr;
+                do {
+                    *hole = std::move(*prev);
+                    hole = prev;
+                } while (elem < *--prev);
+                *hole = std::move(elem);
+            }
+        }
+    }
+
+    /* insertion sort [begin, end) but give up once the elements have moved more than pdq_partial_insertion_limit
+       places, return whether the range is sorted */
+    template <typename Iterator>
+    bool partial_insertion_sort(Iterator begin, Iterator end) {
+        if (begin == end) {
+            return true;
+        }
+        std::ptrdiff_t moved = 0;
+        for (auto itr = begin + 1; itr != end; ++itr) {
+            auto prev = itr - 1;
+            if (*itr < *prev) {
+                auto elem = std::move(*itr);
+                auto hole = itr;
+                do {
+                    *hole = std::move(*prev);
+                    hole = prev;
+                } while (hole != begin && elem < *--prev);
+                *hole = std::move(elem);
+                moved += itr - hole;
+            }
+            if (moved > pdq_partial_insertion_limit) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // sort *a, *b and *c in place
+    template <typename Iterator>
+    void sort3(Iterator a, Iterator b, Iterator c) {
+        if (*b < *a) {
+            mtl::swap(*a, *b);
+        }
+        if (*c < *b) {
+            mtl::swap(*b, *c);
+        }
+        if (*b < *a) {
+            mtl::swap(*a, *b);
+        }
+    }
+
+    /* partition [begin, end) around *begin, the elements equal to the pivot go to the right part
+       return the final position of the pivot, and whether no element had to be swapped.
+       there must be an element not less than the pivot after the range or in it, unless begin is the leftmost */
+    template <typename Iterator>
+    std::pair<Iterator, bool> partition_right(Iterator begin, Iterator end) {
+        auto pivot = std::move(*begin);
+        auto first = begin;
+        auto last = end;
+
+        // the pivot is a median, so the scans stop inside the range except the first right scan
+        while (*++first < pivot) {}
+        if (first - 1 == begin) {
+            while (first < last && !(*--last < pivot)) {}
+        } else {
+            while (!(*--last < pivot)) {}
+        }
+
+        bool already_partitioned = first >= last;
+        while (first < last) {
+            mtl::swap(*first, *last);
+            while (*++first < pivot) {}
+            while (!(*--last < pivot)) {}
+        }
+
+        auto pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    /* swap the elements at first + offsets_l[i] and last - offsets_r[i] for i in [0, num)
+       unless use_swaps, the pairs are chained into one cycle of moves, which takes 2 * num + 1 moves
+       instead of 3 * num, the elements end up on the right sides but not at the paired places */
+    template <typename Iterator>
+    void swap_offsets(Iterator first, Iterator last, const unsigned char* offsets_l, const unsigned char* offsets_r,
+                      std::ptrdiff_t num, bool use_swaps) {
+        if (use_swaps) {
+            for (std::ptrdiff_t i = 0; i < num; ++i) {
+                mtl::swap(*(first + offsets_l[i]), *(last - offsets_r[i]));
+            }
+        } else if (num > 0) {
+            auto l = first + offsets_l[0];
+            auto r = last - offsets_r[0];
+            auto elem = std::move(*l);
+            *l = std::move(*r);
+            for (std::ptrdiff_t i = 1; i < num; ++i) {
+                l = first + offsets_l[i];
+                *r = std::move(*l);
+                r = last - offsets_r[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(elem);
+        }
+    }
+
+    /* the same as partition_right, but the misplaced elements are found by blocks of pdq_block_size,
+       the result of each comparison is added to a count instead of taking a branch */
+    template <typename Iterator>
+    std::pair<Iterator, bool> partition_right_branchless(Iterator begin, Iterator end) {
+        auto pivot = std::move(*begin);
+        auto first = begin;
+        auto last = end;
+
+        while (*++first < pivot) {}
+        if (first - 1 == begin) {
+            while (first < last && !(*--last < pivot)) {}
+        } else {
+            while (!(*--last < pivot)) {}
+        }
+
+        bool already_partitioned = first >= last;
+        if (!already_partitioned) {
+            mtl::swap(*first, *last);
+            ++first;
+
+            // the offsets from offsets_l_base of the elements not less than the pivot on the left,
+            // and from offsets_r_base of the ones less than the pivot on the right
+            alignas(64) unsigned char offsets_l[pdq_block_size];
+            alignas(64) unsigned char offsets_r[pdq_block_size];
+            auto offsets_l_base = first;
+            auto offsets_r_base = last;
+            std::ptrdiff_t num_l = 0;
+            std::ptrdiff_t num_r = 0;
+            std::ptrdiff_t start_l = 0;
+            std::ptrdiff_t start_r = 0;
+
+            while (first < last) {
+                // refill the sides which run out of offsets, splitting the rest if both do
+                std::ptrdiff_t num_unknown = last - first;
+                std::ptrdiff_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                std::ptrdiff_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+                if (left_split >= pdq_block_size) {
+                    for (std::ptrdiff_t i = 0; i < pdq_block_size;) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !(*first < pivot);
+                        ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !(*first < pivot);
+                        ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !(*first < pivot);
+                        ++first;
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !(*first < pivot);
+                        ++first;
+                    }
+                } else {
+                    for (std::ptrdiff_t i = 0; i < left_split;) {
+                        offsets_l[num_l] = static_cast<unsigned char>(i++);
+                        num_l += !(*first < pivot);
+                        ++first;
+                    }
+                }
+
+                if (right_split >= pdq_block_size) {
+                    for (std::ptrdiff_t i = 0; i < pdq_block_size;) {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += *--last < pivot;
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += *--last < pivot;
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += *--last < pivot;
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += *--last < pivot;
+                    }
+                } else {
+                    for (std::ptrdiff_t i = 0; i < right_split;) {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += *--last < pivot;
+                    }
+                }
+
+                std::ptrdiff_t num = num_l < num_r ? num_l : num_r;
+                mtl::swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num,
+                             num_l == num_r);
+                num_l -= num;
+                num_r -= num;
+                start_l += num;
+                start_r += num;
+                if (num_l == 0) {
+                    start_l = 0;
+                    offsets_l_base = first;
+                }
+                if (num_r == 0) {
+                    start_r = 0;
+                    offsets_r_base = last;
+                }
+            }
+
+            // one side may have offsets left, move those elements to the boundary
+            if (num_l) {
+                while (num_l--) {
+                    mtl::swap(*(offsets_l_base + offsets_l[start_l + num_l]), *--last);
+                }
+                first = last;
+            }
+            if (num_r) {
+                while (num_r--) {
+                    mtl::swap(*(offsets_r_base - offsets_r[start_r + num_r]), *first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+
+        auto pivot_pos = first - 1;
+        *begin = std::move(*pivot_pos);
+        *pivot_pos = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    /* partition [begin, end) around *begin, the elements equal to the pivot go to the left part
+       it's used when the pivot equals the element before the range, so nothing in the range is less than it,
+       the left part are all equal and needn't be sorted. return the final position of the pivot */
+    template <typename Iterator>
+    Iterator partition_left(Iterator begin, Iterator end) {
+        auto pivot = std::move(*begin);
+        auto first = begin;
+        auto last = end;
+
+        while (pivot < *--last) {}
+        if (last + 1 == end) {
+            while (first < last && !(pivot < *++first)) {}
+        } else {
+            while (!(pivot < *++first)) {}
+        }
+
+        while (first < last) {
+            mtl::swap(*first, *last);
+            while (pivot < *--last) {}
+            while (!(pivot < *++first)) {}
+        }
+
+        *begin = std::move(*last);
+        *last = std::move(pivot);
+        return last;
+    }
+
+    /* bad_allowed is the number of the highly unbalanced partitions allowed before switching to heapsort,
+       leftmost tells whether [begin, end) is the leftmost part, otherwise the element before begin is a
+       former pivot not greater than any element in the range */
+    template <bool Branchless, typename Iterator>
+    void pdqsort_loop(Iterator begin, Iterator end, size_t bad_allowed, bool leftmost) {
+        while (true) {
+            auto len = end - begin;
+            if (len < pdq_insertion_threshold) {
+                if (leftmost) {
+                    mtl::insertion_sort(begin, end);
+                } else {
+                    mtl::unguarded_insertion_sort(begin, end);
+                }
+                return;
+            }
+
+            // the pivot goes to *begin, by the median of 3 or the ninther for the large ranges
+            auto half = len / 2;
+            if (len > pdq_ninther_threshold) {
+                mtl::sort3(begin, begin + half, end - 1);
+                mtl::sort3(begin + 1, begin + (half - 1), end - 2);
+                mtl::sort3(begin + 2, begin + (half + 1), end - 3);
+                mtl::sort3(begin + (half - 1), begin + half, begin + (half + 1));
+                mtl::swap(*begin, *(begin + half));
+            } else {
+                mtl::sort3(begin + half, begin, end - 1);
+            }
+
+            // the pivot equals the former one, put the equal elements aside and sort the greater ones only
+            if (!leftmost && !(*(begin - 1) < *begin)) {
+                begin = mtl::partition_left(begin, end) + 1;
+                continue;
+            }
+
+            std::pair<Iterator, bool> result;
+            if constexpr (Branchless) {
+                result = mtl::partition_right_branchless(begin, end);
+            } else {
+                result = mtl::partition_right(begin, end);
+            }
+            auto pivot_pos = result.first;
+            auto l_len = pivot_pos - begin;
+            auto r_len = end - (pivot_pos + 1);
+
+            if (l_len < len / 8 || r_len < len / 8) {
+                // the partition is highly unbalanced, break the patterns by swapping a few elements
+                if (--bad_allowed == 0) {
+                    mtl::heapsort(begin, end);
+                    return;
+                }
+                if (l_len >= pdq_insertion_threshold) {
+                    mtl::swap(*begin, *(begin + l_len / 4));
+                    mtl::swap(*(pivot_pos - 1), *(pivot_pos - l_len / 4));
+                    if (l_len > pdq_ninther_threshold) {
+                        mtl::swap(*(begin + 1), *(begin + (l_len / 4 + 1)));
+                        mtl::swap(*(begin + 2), *(begin + (l_len / 4 + 2)));
+                        mtl::swap(*(pivot_pos - 2), *(pivot_pos - (l_len / 4 + 1)));
+                        mtl::swap(*(pivot_pos - 3), *(pivot_pos - (l_len / 4 + 2)));
+                    }
+                }
+                if (r_len >= pdq_insertion_threshold) {
+                    mtl::swap(*(pivot_pos + 1), *(pivot_pos + (1 + r_len / 4)));
+                    mtl::swap(*(end - 1), *(end - r_len / 4));
+                    if (r_len > pdq_ninther_threshold) {
+                        mtl::swap(*(pivot_pos + 2), *(pivot_pos + (2 + r_len / 4)));
+                        mtl::swap(*(pivot_pos + 3), *(pivot_pos + (3 + r_len / 4)));
+                        mtl::swap(*(end - 2), *(end - (1 + r_len / 4)));
+                        mtl::swap(*(end - 3), *(end - (2 + r_len / 4)));
+                    }
+                }
+            } else if (result.second && mtl::partial_insertion_sort(begin, pivot_pos) &&
+                       mtl::partial_insertion_sort(pivot_pos + 1, end)) {
+                // the range was partitioned already and both parts are nearly sorted
+                return;
+            }
+
+            mtl::pdqsort_loop<Branchless>(begin, pivot_pos, bad_allowed, leftmost);
+            begin = pivot_pos + 1;
+            leftmost = false;
         }
     }
 
+    template <typename Iterator>
+    void pdqsort(Iterator begin, Iterator end) {
+        if (end - begin < 2) {
+            return;
+        }
+        // the comparisons of the arithmetic types are cheap and can't throw, so they're done by blocks
+        using T = typename std::iterator_traits<Iterator>::value_type;
+        pdqsort_loop<std::is_arithmetic<T>::value>(begin, end, mtl::floor_log2(static_cast<size_t>(end - begin)), true);
+    }
+
     template <typename Iterator>
     Iterator partition(Iterator begin, Iterator end) noexcept {
         // the pivot
@@ -117,11 +660,16 @@ namespace mtl {
 
     template <typename Iterator>
     void inplace_mergesort(Iterator begin, Iterator end) {
-        if (begin != end && begin != end - 1) {
-            auto mid = find_mid(begin, end);
-            inplace_mergesort(begin, mid);
-            inplace_mergesort(mid, end);
-            inplace_merge(begin, mid, end);
+        // nothing to sort with fewer than 2 elements
+        if (begin == end) {
+            return;
+        }
+        auto second = begin;
+        if (++second != end) {
+            auto mid = mtl::find_mid(begin, end);
+            mtl::inplace_mergesort(begin, mid);
+            mtl::inplace_mergesort(mid, end);
+            mtl::inplace_merge(begin, mid, end);
         }
     }
 
@@ -129,8 +677,8 @@ namespace mtl {
     void inplace_merge(Iterator begin, Iterator mid, Iterator end) noexcept {
         using T = typename std::remove_reference<decltype(*begin)>::type;
 
-        size_t len1 = count_length(begin, mid);
-        size_t len2 = count_length(mid, end);
+        size_t len1 = mtl::count_length(begin, mid);
+        size_t len2 = mtl::count_length(mid, end);
 
         auto buf = new T [len1 + len2];
 
@@ -140,15 +688,15 @@ namespace mtl {
         auto buf_end1 = buf_begin2;
         auto buf_end2 = buf_end1 + len2;
 
-        replace(buf_begin1, buf_end2, begin, end);
+        mtl::replace(buf_begin1, buf_end2, begin, end);
 
-        for (auto itr = begin; itr < end; ++itr) {
+        for (auto itr = begin; itr != end; ++itr) {
             if (buf_begin1 == buf_end1) {
-                replace(itr, end, buf_begin2, buf_end2);
+                mtl::replace(itr, end, buf_begin2, buf_end2);
                 break;
             }
             if (buf_begin2 == buf_end2) {
-                replace(itr, end, buf_begin1, buf_end1);
+                mtl::replace(itr, end, buf_begin1, buf_end1);
                 break;
             }
             if (*buf_begin2 > *buf_begin1) {
@@ -163,17 +711,21 @@ namespace mtl {
 
     template <typename Iterator>
     Iterator find_mid(Iterator begin, Iterator end) {
-        auto fast = begin;
-        auto slow = begin;
-        while (fast != end) {
-            ++fast;
-            if (fast == end) {
-                break;
+        if constexpr (is_random_access_iterator_v<Iterator>) {
+            return begin + (end - begin) / 2;
+        } else {
+            auto fast = begin;
+            auto slow = begin;
+            while (fast != end) {
+                ++fast;
+                if (fast == end) {
+                    break;
+                }
+                ++fast;
+                ++slow;
             }
-            ++fast;
-            ++slow;
+            return slow;
         }
-        return slow;
     }
 }
 
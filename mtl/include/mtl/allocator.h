@@ -0,0 +1,325 @@
+#ifndef MTL_ALLOCATOR_H
+#define MTL_ALLOCATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace mtl {
+    typedef std::size_t size_t;
+
+    /* An allocator getting memory from malloc, it provides reallocate so that the containers can
+       resize their arrays of trivially relocatable elements in place.
+       On Linux the arrays of at least MapThreshold bytes are mapped by mmap directly and resized by mremap,
+       which moves pages instead of copying bytes, so growing a huge array never needs the old and the new copy
+       at the same time. Elsewhere they are handled by realloc. */
+    template <typename T, size_t MapThreshold = (size_t(1) << 25)>
+    class malloc_allocator {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "malloc can't satisfy the alignment of T");
+
+    private:
+        // whether an array of n elements is mapped by mmap
+        static bool is_mapped(size_t n) noexcept {
+#if defined(__linux__)
+            return n * sizeof(T) >= MapThreshold;
+#else
+            (void) n;
+            return false;
+#endif
+        }
+
+#if defined(__linux__)
+        // round the bytes of n elements up to whole pages
+        static size_t mapped_bytes(size_t n) noexcept {
+            static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            return (n * sizeof(T) + page - 1) / page * page;
+        }
+#endif
+
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind {
+            typedef malloc_allocator<U, MapThreshold> other;
+        };
+
+        malloc_allocator() = default;
+
+        template <typename U>
+        malloc_allocator(const malloc_allocator<U, MapThreshold>&) noexcept {}
+
+        T* allocate(size_t n);
+
+        void deallocate(T* p, size_t n) noexcept;
+
+        /* resize the array p with old_n elements to new_n elements, the bytes of the first min(old_n, new_n)
+           elements are kept. The array may be moved, and p is invalid after a successful call. */
+        T* reallocate(T* p, size_t old_n, size_t new_n);
+    };
+
+    template <typename T, size_t MapThreshold>
+    T* malloc_allocator<T, MapThreshold>::allocate(size_t n) {
+#if defined(__linux__)
+        if (is_mapped(n)) {
+            void* p = mmap(nullptr, mapped_bytes(n), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        }
+#endif
+        void* p = std::malloc(n * sizeof(T));
+        if (!p && n) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    template <typename T, size_t MapThreshold>
+    void malloc_allocator<T, MapThreshold>::deallocate(T* p, size_t n) noexcept {
+#if defined(__linux__)
+        if (is_mapped(n)) {
+            munmap(p, mapped_bytes(n));
+            return;
+        }
+#endif
+        (void) n;
+        std::free(p);
+    }
+
+    template <typename T, size_t MapThreshold>
+    T* malloc_allocator<T, MapThreshold>::reallocate(T* p, size_t old_n, size_t new_n) {
+#if defined(__linux__)
+        if (is_mapped(old_n) && is_mapped(new_n)) {
+            void* q = mremap(p, mapped_bytes(old_n), mapped_bytes(new_n), MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(q);
+        }
+        if (is_mapped(old_n) || is_mapped(new_n)) {
+            // one side is mapped and the other is from malloc, so the bytes have to be copied
+            T* q = allocate(new_n);
+            std::memcpy(static_cast<void*>(q), static_cast<const void*>(p),
+                        (old_n < new_n ? old_n : new_n) * sizeof(T));
+            deallocate(p, old_n);
+            return q;
+        }
+#endif
+        void* q = std::realloc(p, new_n * sizeof(T));
+        if (!q && new_n) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(q);
+    }
+
+    template <typename T, typename U, size_t MapThreshold>
+    bool operator==(const malloc_allocator<T, MapThreshold>&, const malloc_allocator<U, MapThreshold>&) noexcept {
+        return true;
+    }
+
+    template <typename T, typename U, size_t MapThreshold>
+    bool operator!=(const malloc_allocator<T, MapThreshold>&, const malloc_allocator<U, MapThreshold>&) noexcept {
+        return false;
+    }
+
+    /* An allocator aligning the arrays to Alignment bytes (a cache line by default), so that the SIMD loops
+       over the elements start at an aligned head and no element straddles two cache lines. */
+    template <typename T, size_t Alignment = 64>
+    class aligned_allocator {
+        static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of 2");
+
+    private:
+        // never align less than T itself requires
+        static constexpr size_t alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind {
+            typedef aligned_allocator<U, Alignment> other;
+        };
+
+        aligned_allocator() = default;
+
+        template <typename U>
+        aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+        T* allocate(size_t n) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+        }
+
+        void deallocate(T* p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t(alignment));
+        }
+    };
+
+    template <typename T, typename U, size_t Alignment>
+    bool operator==(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) noexcept {
+        return true;
+    }
+
+    template <typename T, typename U, size_t Alignment>
+    bool operator!=(const aligned_allocator<T, Alignment>&, const aligned_allocator<U, Alignment>&) noexcept {
+        return false;
+    }
+
+    /* An allocator backing the arrays of at least Threshold bytes by huge pages, so that scanning a huge array
+       doesn't thrash the TLB. On Linux such an array is mapped with MAP_HUGETLB first, if no huge page is reserved
+       it falls back to a normal mapping aligned to a huge page and marked by MADV_HUGEPAGE for the transparent
+       huge pages. The smaller arrays, and all the arrays elsewhere, are aligned to Alignment bytes like
+       aligned_allocator. */
+    template <typename T, size_t Threshold = (size_t(1) << 21), size_t Alignment = 64>
+    class huge_page_allocator {
+        static_assert((Alignment & (Alignment - 1)) == 0, "the alignment must be a power of 2");
+
+    private:
+        static constexpr size_t alignment = Alignment > alignof(T) ? Alignment : alignof(T);
+
+        // the size of the huge pages on x86-64 and aarch64 with 4 KiB base pages
+        static constexpr size_t huge_page_size = size_t(1) << 21;
+
+        // whether an array of n elements is backed by huge pages
+        static bool is_mapped(size_t n) noexcept {
+#if defined(__linux__)
+            return n * sizeof(T) >= Threshold;
+#else
+            (void) n;
+            return false;
+#endif
+        }
+
+#if defined(__linux__)
+        // round the bytes of n elements up to whole huge pages
+        static size_t mapped_bytes(size_t n) noexcept {
+            return (n * sizeof(T) + huge_page_size - 1) / huge_page_size * huge_page_size;
+        }
+
+        static void* map_huge_pages(size_t bytes) noexcept;
+#endif
+
+    public:
+        typedef T value_type;
+
+        template <typename U>
+        struct rebind {
+            typedef huge_page_allocator<U, Threshold, Alignment> other;
+        };
+
+        huge_page_allocator() = default;
+
+        template <typename U>
+        huge_page_allocator(const huge_page_allocator<U, Threshold, Alignment>&) noexcept {}
+
+        T* allocate(size_t n);
+
+        void deallocate(T* p, size_t n) noexcept;
+    };
+
+#if defined(__linux__)
+    template <typename T, size_t Threshold, size_t Alignment>
+    void* huge_page_allocator<T, Threshold, Alignment>::map_huge_pages(size_t bytes) noexcept {
+#if defined(MAP_HUGETLB)
+        void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            return p;
+        }
+#endif
+        // map one more huge page and cut the ends, so that the array starts at a huge page boundary
+        void* q = mmap(nullptr, bytes + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (q == MAP_FAILED) {
+            return nullptr;
+        }
+        auto begin = reinterpret_cast<std::uintptr_t>(q);
+        auto head = (begin + huge_page_size - 1) / huge_page_size * huge_page_size;
+        if (head > begin) {
+            munmap(q, head - begin);
+        }
+        if (begin + huge_page_size > head) {
+            munmap(reinterpret_cast<void*>(head + bytes), begin + huge_page_size - head);
+        }
+#if defined(MADV_HUGEPAGE)
+        madvise(reinterpret_cast<void*>(head), bytes, MADV_HUGEPAGE);
+#endif
+        return reinterpret_cast<void*>(head);
+    }
+#endif
+
+    template <typename T, size_t Threshold, size_t Alignment>
+    T* huge_page_allocator<T, Threshold, Alignment>::allocate(size_t n) {
+#if defined(__linux__)
+        if (is_mapped(n)) {
+            void* p = map_huge_pages(mapped_bytes(n));
+            if (!p) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(p);
+        }
+#endif
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+    }
+
+    template <typename T, size_t Threshold, size_t Alignment>
+    void huge_page_allocator<T, Threshold, Alignment>::deallocate(T* p, size_t n) noexcept {
+#if defined(__linux__)
+        if (is_mapped(n)) {
+            munmap(p, mapped_bytes(n));
+            return;
+        }
+#endif
+        ::operator delete(p, std::align_val_t(alignment));
+    }
+
+    template <typename T, typename U, size_t Threshold, size_t Alignment>
+    bool operator==(const huge_page_allocator<T, Threshold, Alignment>&,
+                    const huge_page_allocator<U, Threshold, Alignment>&) noexcept {
+        return true;
+    }
+
+    template <typename T, typename U, size_t Threshold, size_t Alignment>
+    bool operator!=(const huge_page_allocator<T, Threshold, Alignment>&,
+                    const huge_page_allocator<U, Threshold, Alignment>&) noexcept {
+        return false;
+    }
+
+    /* An allocator refusing every request by throwing a length_error, it's used by the containers which must
+       never touch the heap, e.g. static_vector, so that running out of the local array is reported as an error. */
+    template <typename T>
+    class null_allocator {
+    public:
+        typedef T value_type;
+
+        null_allocator() = default;
+
+        template <typename U>
+        null_allocator(const null_allocator<U>&) noexcept {}
+
+        T* allocate(size_t) {
+            throw std::length_error("The capacity of the container is exhausted.");
+        }
+
+        void deallocate(T*, size_t) noexcept {}
+    };
+
+    template <typename T, typename U>
+    bool operator==(const null_allocator<T>&, const null_allocator<U>&) noexcept {
+        return true;
+    }
+
+    template <typename T, typename U>
+    bool operator!=(const null_allocator<T>&, const null_allocator<U>&) noexcept {
+        return false;
+    }
+}
+
+#endif
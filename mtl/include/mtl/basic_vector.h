@@ -1,53 +1,214 @@
 #ifndef MTL_BASIC_VECTOR_H
 #define MTL_BASIC_VECTOR_H
 
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <utility>
 #include <initializer_list>
+#include <type_traits>
+#include <mtl/type_traits.h>
+#include <mtl/growth_policy.h>
+#include <mtl/vector_view.h>
 
 namespace mtl {
-    typedef unsigned long long size_t;
+    // the tag selecting the default-initializing overloads, e.g. resize(n, default_init)
+    struct default_init_t {
+        explicit default_init_t() = default;
+    };
 
-    template <typename T>
-    class basic_vector {
+    inline constexpr default_init_t default_init{};
+
+    /* The base of the array-based containers. It owns a raw buffer of capacity_ cells,
+       only the cells in [0, size_) hold constructed elements and the rest are uninitialized.
+       An empty basic_vector holds no buffer at all, it's allocated by the first insertion.
+       All the memory is requested from Allocator, which is kept as an empty base when it has no state.
+       The elements of a trivially relocatable T are moved with memmove and the ones of a trivially copyable T
+       are copied with memcpy, the construct and destroy of the Allocator are bypassed for them.
+       Growth is the growth policy (see growth_policy.h) deciding the new capacity on expansion.
+       If the Allocator provides reallocate and T is trivially relocatable, the array is resized by it,
+       which could grow the array in place without copying.
+       A derived class may own a local array (see small_vector.h) by overriding local_buffer and local_capacity,
+       basic_vector uses it whenever the elements fit and never frees it. */
+    template <typename T, typename Allocator = std::allocator<T>, typename Growth = double_growth>
+    class basic_vector : private Allocator {
     private:
+        typedef std::allocator_traits<Allocator> alloc_traits;
+
         // the array contain the data
-        T* data_;   
+        T* data_;
+
+        // the number of constructed elements
+        size_t size_;
 
         // the length of the array
-        size_t capacity_;   
+        size_t capacity_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
 
-        // the default capacity, basic_vector ensures that the capacity won't be smaller than it
-        const static size_t DEFAULT_CAPACITY = 128;   
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
 
-        /* allocate a new array with length capacity
+        /* allocate an uninitialized array with length size, no constructor is called
            it don't delete the original array */
-        void allocate(size_t size) {
-            data_ = new T [size];
+        T* allocate(size_t size) {
+            return alloc_traits::allocate(alloc(), size);
+        }
+
+        // free an array with length size returned by allocate, the elements in it should have been destroyed
+        void deallocate(T* data, size_t size) noexcept {
+            if (data) {
+                alloc_traits::deallocate(alloc(), data, size);
+            }
+        }
+
+        // move construct [first, last) into dest and destroy the originals, from front to back
+        void relocate(T* first, T* last, T* dest) noexcept;
+
+        // the same with relocate but from back to front, used when dest overlaps the tail of the source
+        void relocate_backward(T* first, T* last, T* dest_last) noexcept;
+
+        // copy the elements of rhs into the array, which should be empty and large enough
+        void copy_from(const basic_vector& rhs);
+
+        // the capacity to be allocated when at least required cells are needed
+        size_t next_capacity(size_t required) const {
+            return Growth::next_capacity(capacity_, required);
+        }
+
+        // whether the elements are in the local array of the derived class
+        bool in_local_buffer() noexcept {
+            return data_ && data_ == local_buffer();
+        }
+
+        // move the elements into new_data with length new_capacity and free the old array unless it's local
+        void replace_array(T* new_data, size_t new_capacity) noexcept;
+
+        // move the elements into a new array with length new_capacity (or the local array if they fit) and free the old one
+        void reallocate(size_t new_capacity);
+
+        // construct elements with args at the end until there are n, the capacity should be enough
+        template <typename... Args>
+        void construct_to(size_t n, const Args&... args);
+
+        // forget the array without freeing it and go back to the local array, the elements should have been moved out
+        void detach_array() noexcept {
+            data_ = local_buffer();
+            size_ = 0;
+            capacity_ = local_capacity();
         }
 
     public:
+        typedef Allocator allocator_type;
+        typedef Growth growth_policy;
+
+        /* whether the move constructor can't throw. It takes over the array, the elements in a local array are
+           moved one by one into the local array of the new container. A vector made from a small_vector may need
+           a new array, vector has the overloads taking small_vector for it, which aren't noexcept */
+        static constexpr bool nothrow_move_constructible = std::is_nothrow_move_constructible<T>::value;
+
+        // whether the move assignment can't throw, it also moves the elements one by one when the allocators differ
+        static constexpr bool nothrow_move_assignable = nothrow_move_constructible &&
+            (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value);
+
         basic_vector();
-        explicit basic_vector(size_t s);
-        basic_vector(const basic_vector<T>& rhs);
-        basic_vector(basic_vector<T>&& rhs) noexcept;
+        explicit basic_vector(const Allocator& alloc);
+        explicit basic_vector(size_t s, const Allocator& alloc = Allocator());
+        basic_vector(const basic_vector& rhs);
+        basic_vector(basic_vector&& rhs) noexcept(nothrow_move_constructible);
         virtual ~basic_vector();
 
-        void expand(size_t new_capacity) noexcept;
-        void shrink(size_t new_capacity) noexcept;
+        // return a copy of the allocator
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        void expand(size_t new_capacity);
+
+        // shrink the array to new_capacity, but never below the size or the initial capacity of Growth
+        void shrink(size_t new_capacity);
+
+        // make sure new_capacity elements fit without another allocation
+        void reserve(size_t new_capacity) {
+            expand(new_capacity);
+        }
+
+        // shrink the array to exactly the size, the local array is used again if the elements fit in it
+        void shrink_to_fit();
+
+        /* change the size to n, the extra elements are destroyed and the new ones are value-initialized
+           the array is grown at most once */
+        void resize(size_t n);
+
+        // the same but the new elements are copies of value
+        void resize(size_t n, const T& value);
 
+        /* the same but the new elements are default-initialized, the trivial ones are left uninitialized
+           so that a bulk loader can fill them without zeroing the array first */
+        void resize(size_t n, default_init_t);
+
+        /* destroy all the elements, the array is kept for reuse if Growth::retain_on_clear
+           otherwise it's freed and nothing will be allocated until the next insertion */
         virtual void clear() {
-            delete [] data_;
-            capacity_ = DEFAULT_CAPACITY;
-            allocate(capacity_);
+            if constexpr (Growth::retain_on_clear) {
+                destroy_from(0);
+            } else {
+                release();
+            }
         }
 
         size_t capacity() const {
             return capacity_;
         }
 
+        size_t size() const {
+            return size_;
+        }
+
+        bool empty() const {
+            return size_ == 0;
+        }
+
         basic_vector& operator=(const basic_vector& rhs);
-        basic_vector& operator=(basic_vector&& rhs) noexcept;
+        basic_vector& operator=(basic_vector&& rhs) noexcept(nothrow_move_assignable);
+
+        // return a view of all the elements, it's invalidated when the array is reallocated
+        vector_view<T> view() noexcept {
+            return vector_view<T>(data_, size_);
+        }
+
+        vector_view<const T> view() const noexcept {
+            return vector_view<const T>(data_, size_);
+        }
 
     protected:
+        /* the local array of the derived class, which is used instead of the allocator while the elements fit in it
+           basic_vector only calls them when the object is completely constructed, the derived class should call
+           adopt_local_buffer in its constructors and release and then adopt_local_buffer(nullptr, 0) in its destructor */
+        virtual T* local_buffer() noexcept {
+            return nullptr;
+        }
+
+        virtual size_t local_capacity() const noexcept {
+            return 0;
+        }
+
+        // use the empty array data with length capacity, the basic_vector should hold no array
+        void adopt_local_buffer(T* data, size_t capacity) noexcept {
+            data_ = data;
+            capacity_ = capacity;
+        }
+
+        // destroy all the elements and free the array, the local array (if any) is used again
+        void release() noexcept;
+
+        /* take over the array of vec, or move its elements one by one into a new array when it's a local array or
+           it belongs to another allocator, which may throw. The basic_vector should hold no element */
+        void move_from(basic_vector& vec);
+
         const T* data() const {
             return data_;
         }
@@ -55,116 +216,493 @@ namespace mtl {
         T* data() {
             return data_;
         }
+
+        // make sure there's room for n more elements, the capacity grows by Growth if it's not enough
+        void check_capacity(size_t n = 1) {
+            if (size_ + n > capacity_) {
+                reallocate(next_capacity(size_ + n));
+            }
+        }
+
+        /* construct a new element at the end with args and return a reference to it
+           the arguments may refer to an element of this container */
+        template <typename... Args>
+        T& construct_back(Args&&... args);
+
+        // destroy the last element, the container should not be empty
+        void destroy_back() noexcept {
+            --size_;
+            alloc_traits::destroy(alloc(), data_ + size_);
+        }
+
+        // construct an element in the uninitialized cell pointed by p with args
+        template <typename... Args>
+        void construct_at(T* p, Args&&... args) {
+            alloc_traits::construct(alloc(), p, std::forward<Args>(args)...);
+        }
+
+        // destroy the elements in [pos, size_)
+        void destroy_from(size_t pos) noexcept;
+
+        /* move the elements in [pos, size_) n cells backward and count the gap [pos, pos + n) in the size
+           the gap is left uninitialized, the caller must construct all the n elements in it */
+        void open_gap(size_t pos, size_t n);
+
+        /* construct the n elements from first in the gap [pos, pos + n) opened by open_gap, they are moved if Move
+           if a constructor throws, the elements constructed so far are destroyed and the gap is closed again */
+        template <bool Move, typename Iterator>
+        void fill_gap(size_t pos, size_t n, Iterator first);
+
+        // destroy the elements in [pos, pos + n) and move the following elements forward to fill the gap
+        void close_gap(size_t pos, size_t n) noexcept;
+
+        /* remove the elements for which drop(index, elem) is true in one stable pass, return the number removed
+           every kept element moves at most once. The trivially relocatable elements are moved in runs by memmove,
+           the others are move-assigned forward and the tail left behind is destroyed.
+           if drop throws, the elements not examined yet are kept */
+        template <typename Drop>
+        size_t compact(Drop drop);
     };
 
-    template <typename T>
-    basic_vector<T>::basic_vector() : capacity_(DEFAULT_CAPACITY) {
-        allocate(capacity_); 
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::basic_vector() : data_(nullptr), size_(0), capacity_(0) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::basic_vector(const Allocator& alloc) :
+        Allocator(alloc), data_(nullptr), size_(0), capacity_(0) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::basic_vector(size_t s, const Allocator& alloc) :
+        Allocator(alloc), data_(nullptr), size_(0), capacity_(0) {
+        expand(s);
     }
 
-    template <typename T>
-    basic_vector<T>::basic_vector(size_t s) : capacity_(s) {
-        capacity_ = capacity_ > DEFAULT_CAPACITY ? capacity_ : DEFAULT_CAPACITY;
-        allocate(capacity_);
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::basic_vector(const basic_vector& vec) :
+        Allocator(alloc_traits::select_on_container_copy_construction(vec.alloc())),
+        data_(nullptr), size_(0), capacity_(0) {
+        if (vec.size_ == 0) {
+            return;
+        }
+        data_ = allocate(vec.size_);
+        capacity_ = vec.size_;
+        try {
+            copy_from(vec);
+        } catch (...) {
+            // the destructor won't run for a constructor which throws, free the copies made so far here
+            destroy_from(0);
+            deallocate(data_, capacity_);
+            throw;
+        }
     }
 
-    template <typename T>
-    basic_vector<T>::basic_vector(const basic_vector<T>& vec) : capacity_(vec.capacity_) {
-        allocate(capacity_);
-        auto vec_data = vec.data_;
-        for (size_t i = 0; i < capacity_; ++i) {
-            data_[i] = vec_data[i];
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::basic_vector(basic_vector&& vec) noexcept(nothrow_move_constructible) :
+        Allocator(vec.alloc()), data_(vec.data_), size_(vec.size_), capacity_(vec.capacity_) {
+        if (vec.in_local_buffer()) {
+            // the local array can't be taken over, move the elements one by one
+            data_ = nullptr;
+            size_ = 0;
+            capacity_ = 0;
+            expand(vec.size_);
+            for (; size_ < vec.size_; ++size_) {
+                alloc_traits::construct(alloc(), data_ + size_, std::move(vec.data_[size_]));
+            }
+            vec.destroy_from(0);
+            return;
         }
+        vec.detach_array();
     }
 
-    template <typename T>
-    basic_vector<T>::basic_vector(basic_vector<T>&& vec) noexcept :
-        data_(vec.data_), capacity_(vec.capacity_) {
-        vec.data_ = nullptr;
-        vec.clear();
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>::~basic_vector() {
+        release();
     }
 
-    template <typename T>
-    basic_vector<T>::~basic_vector() {
-        delete[] data_;
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::relocate(T* first, T* last, T* dest) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // the ranges may overlap when closing a gap
+            if (first != last) {
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+            }
+            return;
+        }
+        for (; first != last; ++first, ++dest) {
+            alloc_traits::construct(alloc(), dest, std::move(*first));
+            alloc_traits::destroy(alloc(), first);
+        }
     }
 
-    template<typename T>
-    void basic_vector<T>::expand(size_t new_capacity) noexcept {
-        if (new_capacity <= capacity_) {
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::relocate_backward(T* first, T* last, T* dest_last) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (first != last) {
+                std::memmove(static_cast<void*>(dest_last - (last - first)), static_cast<const void*>(first),
+                             (last - first) * sizeof(T));
+            }
             return;
         }
-        // backup the original array
-        auto old = data_;
+        while (last != first) {
+            --last;
+            --dest_last;
+            alloc_traits::construct(alloc(), dest_last, std::move(*last));
+            alloc_traits::destroy(alloc(), last);
+        }
+    }
 
-        // create a new array
-        allocate(new_capacity);
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::copy_from(const basic_vector& vec) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (vec.size_ != 0) {
+                std::memcpy(static_cast<void*>(data_), static_cast<const void*>(vec.data_), vec.size_ * sizeof(T));
+            }
+            size_ = vec.size_;
+            return;
+        }
+        // copy only the constructed elements
+        for (; size_ < vec.size_; ++size_) {
+            alloc_traits::construct(alloc(), data_ + size_, vec.data_[size_]);
+        }
+    }
 
-        // move the elements
-        for (size_t i = 0; i < capacity_; ++i) {
-            data_[i] = std::move(old[i]);
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::replace_array(T* new_data, size_t new_capacity) noexcept {
+        // move the elements and free the original array
+        relocate(data_, data_ + size_, new_data);
+        if (!in_local_buffer()) {
+            deallocate(data_, capacity_);
         }
+
+        data_ = new_data;
         capacity_ = new_capacity;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::reallocate(size_t new_capacity) {
+        // go back to the local array if the elements fit in it
+        if (new_capacity <= local_capacity()) {
+            if (!in_local_buffer()) {
+                replace_array(local_buffer(), local_capacity());
+            }
+            return;
+        }
+
+        // resize the array directly, it may grow in place
+        if constexpr (is_trivially_relocatable_v<T> && has_reallocate_v<Allocator>) {
+            if (data_ && !in_local_buffer()) {
+                data_ = alloc().reallocate(data_, capacity_, new_capacity);
+                capacity_ = new_capacity;
+                return;
+            }
+        }
+
+        // create a new array
+        replace_array(allocate(new_capacity), new_capacity);
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::release() noexcept {
+        destroy_from(0);
+        if (!in_local_buffer()) {
+            deallocate(data_, capacity_);
+        }
+        data_ = local_buffer();
+        capacity_ = local_capacity();
+    }
 
-        delete [] old;
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::expand(size_t new_capacity) {
+        if (new_capacity <= capacity_) {
+            return;
+        }
+        reallocate(new_capacity);
     }
 
-    template<typename T>
-    void basic_vector<T>::shrink(size_t new_capacity) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::shrink(size_t new_capacity) {
         if (new_capacity >= capacity_) {
             return;
         }
-        // backup the original array
-        auto old = data_;
 
-        // create a new array
-        capacity_ = new_capacity > DEFAULT_CAPACITY ? new_capacity : DEFAULT_CAPACITY;
-        allocate(capacity_);
+        // never drop the constructed elements, and keep at least the initial capacity unless they fit in the local array
+        new_capacity = new_capacity > size_ ? new_capacity : size_;
+        if (new_capacity > local_capacity() && new_capacity < Growth::initial_capacity) {
+            new_capacity = Growth::initial_capacity;
+        }
+        if (new_capacity >= capacity_) {
+            return;
+        }
+        reallocate(new_capacity);
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::shrink_to_fit() {
+        if (size_ == capacity_ || in_local_buffer()) {
+            return;
+        }
+        if (size_ == 0) {
+            release();
+            return;
+        }
+        reallocate(size_);
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    void basic_vector<T, Allocator, Growth>::construct_to(size_t n, const Args&... args) {
+        for (; size_ < n; ++size_) {
+            alloc_traits::construct(alloc(), data_ + size_, args...);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::resize(size_t n) {
+        if (n <= size_) {
+            destroy_from(n);
+            return;
+        }
+        check_capacity(n - size_);
+        construct_to(n);
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::resize(size_t n, const T& value) {
+        if (n <= size_) {
+            destroy_from(n);
+            return;
+        }
+        if (n > capacity_) {
+            // value may refer to an element of this container
+            T temp(value);
+            check_capacity(n - size_);
+            construct_to(n, temp);
+            return;
+        }
+        construct_to(n, value);
+    }
 
-        // move the elements
-        for (size_t i = 0; i < new_capacity; ++i) {
-            data_[i] = std::move(old[i]);
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::resize(size_t n, default_init_t) {
+        if (n <= size_) {
+            destroy_from(n);
+            return;
+        }
+        check_capacity(n - size_);
+        if constexpr (std::is_trivially_default_constructible<T>::value) {
+            size_ = n;
+        } else {
+            // the construct of the allocator always value-initializes, so place the elements directly
+            for (; size_ < n; ++size_) {
+                ::new (static_cast<void*>(data_ + size_)) T;
+            }
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    T& basic_vector<T, Allocator, Growth>::construct_back(Args&&... args) {
+        if (size_ < capacity_) {
+            alloc_traits::construct(alloc(), data_ + size_, std::forward<Args>(args)...);
+            return data_[size_++];
+        }
+
+        if constexpr (is_trivially_relocatable_v<T> && has_reallocate_v<Allocator>) {
+            // the arguments may be invalidated by reallocate, so construct the element in advance
+            T temp(std::forward<Args>(args)...);
+            reallocate(next_capacity(size_ + 1));
+            alloc_traits::construct(alloc(), data_ + size_, std::move(temp));
+            return data_[size_++];
+        }
+
+        /* construct the new element in the new array before moving the old ones,
+           so that the arguments referring to the old elements are still valid */
+        size_t new_capacity = next_capacity(size_ + 1);
+        T* new_data = allocate(new_capacity);
+        try {
+            alloc_traits::construct(alloc(), new_data + size_, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        replace_array(new_data, new_capacity);
+        return data_[size_++];
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::destroy_from(size_t pos) noexcept {
+        if constexpr (std::is_trivially_destructible<T>::value) {
+            size_ = pos < size_ ? pos : size_;
+            return;
+        }
+        while (size_ > pos) {
+            destroy_back();
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::open_gap(size_t pos, size_t n) {
+        check_capacity(n);
+        relocate_backward(data_ + pos, data_ + size_, data_ + size_ + n);
+        size_ += n;
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <bool Move, typename Iterator>
+    void basic_vector<T, Allocator, Growth>::fill_gap(size_t pos, size_t n, Iterator first) {
+        T* gap = data_ + pos;
+        if constexpr (std::is_trivially_copyable<T>::value && std::is_pointer<Iterator>::value &&
+                      std::is_same<std::remove_cv_t<std::remove_pointer_t<Iterator>>, T>::value) {
+            // a contiguous source of the same trivial type is copied at once
+            if (n != 0) {
+                std::memcpy(static_cast<void*>(gap), static_cast<const void*>(first), n * sizeof(T));
+            }
+            return;
         }
 
-        delete [] old;
+        size_t i = 0;
+        try {
+            for (; i < n; ++i, ++first) {
+                if constexpr (Move) {
+                    alloc_traits::construct(alloc(), gap + i, std::move(*first));
+                } else {
+                    alloc_traits::construct(alloc(), gap + i, *first);
+                }
+            }
+        } catch (...) {
+            for (size_t j = 0; j < i; ++j) {
+                alloc_traits::destroy(alloc(), gap + j);
+            }
+            relocate(gap + n, data_ + size_, gap);
+            size_ -= n;
+            throw;
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::close_gap(size_t pos, size_t n) noexcept {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (size_t i = pos; i < pos + n; ++i) {
+                alloc_traits::destroy(alloc(), data_ + i);
+            }
+        }
+        relocate(data_ + pos + n, data_ + size_, data_ + pos);
+        size_ -= n;
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename Drop>
+    size_t basic_vector<T, Allocator, Growth>::compact(Drop drop) {
+        // nothing moves before the first removed element
+        size_t read = 0;
+        while (read < size_ && !drop(read, data_[read])) {
+            ++read;
+        }
+        if (read == size_) {
+            return 0;
+        }
+        size_t old_size = size_;
+        size_t write = read;
+
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // the removed elements are destroyed at once, the runs of kept elements are moved over the holes
+            alloc_traits::destroy(alloc(), data_ + read);
+            size_t run = ++read;
+            try {
+                for (; read < old_size; ++read) {
+                    if (drop(read, data_[read])) {
+                        relocate(data_ + run, data_ + read, data_ + write);
+                        write += read - run;
+                        alloc_traits::destroy(alloc(), data_ + read);
+                        run = read + 1;
+                    }
+                }
+            } catch (...) {
+                relocate(data_ + run, data_ + old_size, data_ + write);
+                size_ = write + (old_size - run);
+                throw;
+            }
+            relocate(data_ + run, data_ + old_size, data_ + write);
+            size_ = write + (old_size - run);
+        } else {
+            try {
+                for (++read; read < old_size; ++read) {
+                    if (!drop(read, data_[read])) {
+                        data_[write++] = std::move(data_[read]);
+                    }
+                }
+            } catch (...) {
+                for (; read < old_size; ++read) {
+                    data_[write++] = std::move(data_[read]);
+                }
+                destroy_from(write);
+                throw;
+            }
+            destroy_from(write);
+        }
+        return old_size - size_;
     }
 
-    template <typename T>
-    basic_vector<T>& basic_vector<T>::operator=(const basic_vector<T>& vec) {
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>& basic_vector<T, Allocator, Growth>::operator=(const basic_vector& vec) {
         // process the self-assignment
         if (this == &vec) {
             return *this;
         }
 
-        // delete original array
-        delete [] data_;
+        // the array can't be freed by another allocator, so release it before taking over the allocator
+        if (alloc_traits::propagate_on_container_copy_assignment::value && alloc() != vec.alloc()) {
+            release();
+        }
+        if (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc() = vec.alloc();
+        }
 
-        capacity_ = vec.capacity_;
-        data_ = allocate(capacity_);
+        // reuse the array if it's big enough
+        if (vec.size_ > capacity_) {
+            release();
+            data_ = allocate(vec.size_);
+            capacity_ = vec.size_;
+        } else {
+            destroy_from(0);
+        }
 
         // copy every element
-        for (size_t i = 0; i < capacity_; ++i) {
-            data_[i] = vec.data_[i];
-        }
+        copy_from(vec);
 
         return *this;
     }
 
-    template <typename T>
-    basic_vector<T>& basic_vector<T>::operator=(basic_vector<T>&& vec) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    basic_vector<T, Allocator, Growth>& basic_vector<T, Allocator, Growth>::operator=(basic_vector&& vec)
+        noexcept(nothrow_move_assignable) {
         if (this == &vec) {
             return *this;
         }
         // delete original array
-        delete [] data_;
-
-        // copy the object
-        capacity_ = vec.capacity_;
-        data_ = vec.data_;
+        release();
+        move_from(vec);
+        return *this;
+    }
 
-        vec.data_ = nullptr;
+    template <typename T, typename Allocator, typename Growth>
+    void basic_vector<T, Allocator, Growth>::move_from(basic_vector& vec) {
+        bool same_alloc = alloc_traits::propagate_on_container_move_assignment::value || alloc() == vec.alloc();
+        if (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc() = vec.alloc();
+        }
 
-        return *this;
+        if (same_alloc && !vec.in_local_buffer()) {
+            // take over the array
+            data_ = vec.data_;
+            size_ = vec.size_;
+            capacity_ = vec.capacity_;
+
+            vec.detach_array();
+        } else {
+            // the array belongs to another allocator or it's local, move the elements one by one
+            expand(vec.size_);
+            for (; size_ < vec.size_; ++size_) {
+                alloc_traits::construct(alloc(), data_ + size_, std::move(vec.data_[size_]));
+            }
+            vec.release();
+        }
     }
 }
 
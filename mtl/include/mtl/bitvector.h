@@ -0,0 +1,492 @@
+#ifndef MTL_BITVECTOR_H
+#define MTL_BITVECTOR_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <mtl/index_iterator.h>
+#include <mtl/vector.h>
+
+namespace mtl {
+    /* The vector of bits packed into 64-bit words, bit i is bit i % 64 of word i / 64. The bulk operations
+       (&=, |=, ^=, flip, count) work on whole words.
+       rank1(i) counts the ones before position i and select1(k) finds the position of the k-th one, both in O(1)
+       once build_index() has built the index: for every 512 bits the number of ones before them and the counts
+       of each of their 8 words packed into 9-bit fields (25% of the bits), and the block of every 4096-th one.
+       select1 binary searches the blocks between two of these samples, unless they are 4096 blocks apart or
+       more: such a sparse span keeps the positions of its 4096 ones instead (at most 1/8 of its bits), so the
+       search never takes more than 12 steps.
+       Any modification makes the index out of date, the queries throw a logic_error until it's rebuilt.
+       The bits behind size() in the last word are always 0. */
+    class bitvector {
+    public:
+        typedef index_iterator<const bitvector, const bool, bool> const_iterator;
+        typedef const_iterator iterator;
+
+    private:
+        typedef std::uint64_t word_type;
+
+        static constexpr size_t word_bits = 64;
+        static constexpr size_t block_words = 8;
+        static constexpr size_t select_sample = 4096;
+        static constexpr size_t sparse_span_blocks = 4096;
+        static constexpr size_t no_positions = ~size_t(0);
+
+        vector<word_type> words_;
+        size_t size_;
+
+        /* two words per 512-bit block: the number of ones before the block, and the number of ones before
+           word j of the block at bits [9 * (j - 1), 9 * j) for j in [1, 8), one more pair for the end */
+        vector<word_type> ranks_;
+
+        // the block holding the (s * 4096)-th one
+        vector<size_t> samples_;
+
+        // where the positions of the ones of the sparse span s start in positions_, no_positions for a dense one
+        vector<size_t> spans_;
+        vector<size_t> positions_;
+
+        size_t ones_;
+        bool indexed_;
+
+        static unsigned popcount(word_type w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_popcountll(w));
+#else
+            w = w - ((w >> 1) & 0x5555555555555555ULL);
+            w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+            w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<unsigned>((w * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        static unsigned count_trailing_zeros(word_type w) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(__builtin_ctzll(w));
+#else
+            unsigned n = 0;
+            while (!(w & 1)) {
+                w >>= 1;
+                ++n;
+            }
+            return n;
+#endif
+        }
+
+        // the position of the k-th one in w, w should have more than k ones
+        static unsigned select_in_word(word_type w, unsigned k) noexcept;
+
+        size_t words_for(size_t bits) const noexcept {
+            return (bits + word_bits - 1) / word_bits;
+        }
+
+        const word_type* words() const noexcept {
+            return words_.view().data();
+        }
+
+        word_type* words() noexcept {
+            return words_.view().data();
+        }
+
+        // clear the bits behind size() in the last word
+        void trim() noexcept {
+            if (size_ % word_bits) {
+                words()[size_ / word_bits] &= (word_type(1) << (size_ % word_bits)) - 1;
+            }
+        }
+
+        void check_index() const {
+            if (!indexed_) {
+                throw std::logic_error("The rank/select index is out of date, call build_index() first.");
+            }
+        }
+
+        void check_same_size(const bitvector& rhs) const {
+            if (size_ != rhs.size_) {
+                throw std::invalid_argument("The bitvectors have different sizes.");
+            }
+        }
+
+    public:
+        bitvector() : size_(0), ones_(0), indexed_(false) {}
+
+        // n bits which are all value
+        explicit bitvector(size_t n, bool value = false);
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        // the number of bits which fit in the allocated words
+        [[nodiscard]] size_t capacity() const {
+            return words_.capacity() * word_bits;
+        }
+
+        void reserve(size_t n) {
+            words_.reserve(words_for(n));
+        }
+
+        // the new bits are value
+        void resize(size_t n, bool value = false);
+
+        // it don't check the boundary
+        bool operator[](size_t index) const {
+            return (words()[index / word_bits] >> (index % word_bits)) & 1;
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        bool test(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return (*this)[index];
+        }
+
+        void set(size_t index, bool value = true);
+
+        void reset(size_t index) {
+            set(index, false);
+        }
+
+        void flip(size_t index);
+
+        void push_back(bool value);
+
+        void pop_back();
+
+        void clear() noexcept {
+            words_.clear();
+            size_ = 0;
+            indexed_ = false;
+        }
+
+        // the number of ones
+        size_t count() const noexcept;
+
+        // flip all the bits
+        void flip() noexcept;
+
+        // the bitwise operations with a bitvector of the same size, it throw an invalid_argument exception otherwise
+        bitvector& operator&=(const bitvector& rhs);
+        bitvector& operator|=(const bitvector& rhs);
+        bitvector& operator^=(const bitvector& rhs);
+
+        bitvector operator~() const {
+            bitvector result(*this);
+            result.flip();
+            return result;
+        }
+
+        bool operator==(const bitvector& rhs) const;
+
+        bool operator!=(const bitvector& rhs) const {
+            return !(*this == rhs);
+        }
+
+        // the words holding the bits, the bits behind size() are 0
+        vector_view<const word_type> data() const {
+            return vector_view<const word_type>(words(), words_for(size_));
+        }
+
+        // build the rank/select index, it takes O(n / 64) and stays valid until the next modification
+        void build_index();
+
+        // the number of ones in [0, index), index may be size()
+        size_t rank1(size_t index) const;
+
+        // the number of zeros in [0, index)
+        size_t rank0(size_t index) const {
+            return index - rank1(index);
+        }
+
+        // the position of the k-th one counting from 0, it throw an out_of_range exception if there are not enough
+        size_t select1(size_t k) const;
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    inline unsigned bitvector::select_in_word(word_type w, unsigned k) noexcept {
+        // skip the bytes first, then the bits of the byte
+        unsigned pos = 0;
+        for (;;) {
+            unsigned c = popcount(w & 0xFF);
+            if (k < c) {
+                break;
+            }
+            k -= c;
+            w >>= 8;
+            pos += 8;
+        }
+        for (; k; --k) {
+            w &= w - 1;
+        }
+        return pos + count_trailing_zeros(w);
+    }
+
+    inline bitvector::bitvector(size_t n, bool value) : size_(0), ones_(0), indexed_(false) {
+        resize(n, value);
+    }
+
+    inline void bitvector::resize(size_t n, bool value) {
+        size_t old = size_;
+        words_.resize(words_for(n));
+        size_ = n;
+        indexed_ = false;
+        if (n <= old) {
+            trim();
+            return;
+        }
+        if (value) {
+            // fill the rest of the old last word, then the whole words
+            word_type* w = words();
+            size_t i = old;
+            for (; i < n && i % word_bits; ++i) {
+                w[i / word_bits] |= word_type(1) << (i % word_bits);
+            }
+            for (size_t j = words_for(i); j < words_for(n); ++j) {
+                w[j] = ~word_type(0);
+            }
+            trim();
+        }
+    }
+
+    inline void bitvector::set(size_t index, bool value) {
+        if (index >= size_) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        word_type mask = word_type(1) << (index % word_bits);
+        if (value) {
+            words()[index / word_bits] |= mask;
+        } else {
+            words()[index / word_bits] &= ~mask;
+        }
+        indexed_ = false;
+    }
+
+    inline void bitvector::flip(size_t index) {
+        if (index >= size_) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        words()[index / word_bits] ^= word_type(1) << (index % word_bits);
+        indexed_ = false;
+    }
+
+    inline void bitvector::push_back(bool value) {
+        if (size_ % word_bits == 0) {
+            words_.push_back(0);
+        }
+        words()[size_ / word_bits] |= word_type(value) << (size_ % word_bits);
+        ++size_;
+        indexed_ = false;
+    }
+
+    inline void bitvector::pop_back() {
+        if (empty()) {
+            throw std::out_of_range("There's no element to be popped out.");
+        }
+        --size_;
+        if (size_ % word_bits == 0) {
+            words_.pop_back();
+        } else {
+            trim();
+        }
+        indexed_ = false;
+    }
+
+    inline size_t bitvector::count() const noexcept {
+        size_t n = 0;
+        const word_type* w = words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            n += popcount(w[i]);
+        }
+        return n;
+    }
+
+    inline void bitvector::flip() noexcept {
+        word_type* w = words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            w[i] = ~w[i];
+        }
+        trim();
+        indexed_ = false;
+    }
+
+    inline bitvector& bitvector::operator&=(const bitvector& rhs) {
+        check_same_size(rhs);
+        word_type* w = words();
+        const word_type* r = rhs.words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            w[i] &= r[i];
+        }
+        indexed_ = false;
+        return *this;
+    }
+
+    inline bitvector& bitvector::operator|=(const bitvector& rhs) {
+        check_same_size(rhs);
+        word_type* w = words();
+        const word_type* r = rhs.words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            w[i] |= r[i];
+        }
+        indexed_ = false;
+        return *this;
+    }
+
+    inline bitvector& bitvector::operator^=(const bitvector& rhs) {
+        check_same_size(rhs);
+        word_type* w = words();
+        const word_type* r = rhs.words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            w[i] ^= r[i];
+        }
+        indexed_ = false;
+        return *this;
+    }
+
+    inline bool bitvector::operator==(const bitvector& rhs) const {
+        if (size_ != rhs.size_) {
+            return false;
+        }
+        const word_type* w = words();
+        const word_type* r = rhs.words();
+        for (size_t i = 0; i < words_for(size_); ++i) {
+            if (w[i] != r[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline void bitvector::build_index() {
+        size_t nwords = words_for(size_);
+        size_t nblocks = (nwords + block_words - 1) / block_words;
+        const word_type* w = words();
+
+        ranks_.clear();
+        ranks_.reserve(2 * (nblocks + 1));
+        samples_.clear();
+
+        size_t total = 0;
+        for (size_t b = 0; b < nblocks; ++b) {
+            ranks_.push_back(total);
+            word_type packed = 0;
+            size_t in_block = 0;
+            for (size_t j = 0; j < block_words; ++j) {
+                if (j > 0) {
+                    packed |= word_type(in_block) << (9 * (j - 1));
+                }
+                size_t c = b * block_words + j < nwords ? popcount(w[b * block_words + j]) : 0;
+                // record the block of every 4096-th one
+                while (samples_.size() * select_sample < total + in_block + c) {
+                    samples_.push_back(b);
+                }
+                in_block += c;
+            }
+            ranks_.push_back(packed);
+            total += in_block;
+        }
+        ranks_.push_back(total);
+        ranks_.push_back(0);
+
+        // the spans between two samples too long for the binary search keep the positions of their ones
+        spans_.clear();
+        positions_.clear();
+        for (size_t s = 0; s < samples_.size(); ++s) {
+            size_t lo = samples_[s];
+            size_t hi = s + 1 < samples_.size() ? samples_[s + 1] : nblocks - 1;
+            if (hi - lo < sparse_span_blocks) {
+                spans_.push_back(no_positions);
+                continue;
+            }
+            spans_.push_back(positions_.size());
+            size_t first = s * select_sample;
+            size_t stop = first + select_sample < total ? first + select_sample : total;
+            size_t k = ranks_[2 * lo];
+            for (size_t i = lo * block_words; i < nwords && k < stop; ++i) {
+                for (word_type x = w[i]; x && k < stop; x &= x - 1, ++k) {
+                    if (k >= first) {
+                        positions_.push_back(i * word_bits + count_trailing_zeros(x));
+                    }
+                }
+            }
+        }
+
+        ones_ = total;
+        indexed_ = true;
+    }
+
+    inline size_t bitvector::rank1(size_t index) const {
+        check_index();
+        if (index > size_) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        size_t word = index / word_bits;
+        size_t block = word / block_words;
+        size_t j = word % block_words;
+
+        size_t r = ranks_[2 * block];
+        if (j > 0) {
+            r += (ranks_[2 * block + 1] >> (9 * (j - 1))) & 0x1FF;
+        }
+        if (index % word_bits) {
+            r += popcount(words()[word] & ((word_type(1) << (index % word_bits)) - 1));
+        }
+        return r;
+    }
+
+    inline size_t bitvector::select1(size_t k) const {
+        check_index();
+        if (k >= ones_) {
+            throw std::out_of_range("There are not enough ones.");
+        }
+
+        size_t span = spans_[k / select_sample];
+        if (span != no_positions) {
+            return positions_[span + k % select_sample];
+        }
+
+        // the block is between two samples, find the last block starting with at most k ones
+        size_t lo = samples_[k / select_sample];
+        size_t hi = k / select_sample + 1 < samples_.size() ? samples_[k / select_sample + 1] : ranks_.size() / 2 - 2;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo + 1) / 2;
+            if (ranks_[2 * mid] <= k) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        size_t rest = k - ranks_[2 * lo];
+        word_type packed = ranks_[2 * lo + 1];
+        size_t j = 0;
+        while (j + 1 < block_words && ((packed >> (9 * j)) & 0x1FF) <= rest) {
+            ++j;
+        }
+        if (j > 0) {
+            rest -= (packed >> (9 * (j - 1))) & 0x1FF;
+        }
+        size_t word = lo * block_words + j;
+        return word * word_bits + select_in_word(words()[word], static_cast<unsigned>(rest));
+    }
+}
+
+#endif
@@ -0,0 +1,389 @@
+#ifndef MTL_CONCURRENT_VECTOR_H
+#define MTL_CONCURRENT_VECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <mtl/index_iterator.h>
+
+namespace mtl {
+    /* The vector which many threads can append to at once. The elements are kept in segments which are never
+       moved, segment k holds 32 * 2^k elements, so a reference to an element stays valid until the vector is
+       cleared or destroyed, and growing the vector never copies anything.
+       An insertion reserves its slots by an atomic compare-and-swap (allocating the segments it needs first),
+       constructs the elements, and then marks their slots ready. size() is the length of the prefix of ready
+       slots, each insertion advances it over the ready slots behind it, the ones of the other threads included.
+       So no insertion waits for another one: a slow or preempted writer only holds size() below its slots until
+       it finishes, while the others keep appending, and the readers can access every element below size().
+       The elements are moved into their slots, so T must be nothrow move constructible. clear() and the
+       destructor must not run concurrently with anything else. */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class concurrent_vector : private Allocator {
+    public:
+        typedef index_iterator<concurrent_vector<T, Allocator>, T> iterator;
+        typedef index_iterator<const concurrent_vector<T, Allocator>, const T> const_iterator;
+
+    private:
+        typedef std::allocator_traits<Allocator> alloc_traits;
+
+        static constexpr unsigned first_bits = 5;
+        static constexpr size_t first_size = size_t(1) << first_bits;
+        static constexpr size_t max_segments = sizeof(size_t) * 8 - first_bits;
+
+        typedef typename alloc_traits::template rebind_alloc<std::atomic<bool>> flag_allocator;
+        typedef std::allocator_traits<flag_allocator> flag_traits;
+
+        std::atomic<T*> segments_[max_segments];
+
+        // the ready flags of the slots in each segment, a flag is set when its element is constructed
+        std::atomic<std::atomic<bool>*> flags_[max_segments];
+
+        // the number of slots handed out to the insertions
+        std::atomic<size_t> reserved_;
+
+        // the length of the prefix of the ready slots
+        std::atomic<size_t> size_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        static unsigned floor_log2(size_t n) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<unsigned>(sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(n));
+#else
+            unsigned k = 0;
+            while (n >>= 1) {
+                ++k;
+            }
+            return k;
+#endif
+        }
+
+        // the segment containing the element index
+        static unsigned segment_of(size_t index) noexcept {
+            return floor_log2((index >> first_bits) + 1);
+        }
+
+        // the index of the first element of segment k
+        static size_t segment_begin(unsigned k) noexcept {
+            return first_size * ((size_t(1) << k) - 1);
+        }
+
+        static size_t segment_size(unsigned k) noexcept {
+            return first_size << k;
+        }
+
+        // the address of the element index, its segment should be allocated
+        T* slot(size_t index) const noexcept {
+            unsigned k = segment_of(index);
+            return segments_[k].load(std::memory_order_acquire) + (index - segment_begin(k));
+        }
+
+        // the ready flag of the slot index, its segment should be allocated
+        std::atomic<bool>& flag(size_t index) const noexcept {
+            unsigned k = segment_of(index);
+            return flags_[k].load(std::memory_order_acquire)[index - segment_begin(k)];
+        }
+
+        // make sure the segments holding [begin, stop) are allocated, the threads racing for a segment keep one
+        void allocate_segments(size_t begin, size_t stop);
+
+        // reserve n slots, the segments are allocated before they are handed out
+        size_t reserve_slots(size_t n);
+
+        // mark [index, index + n) ready and advance size() over the ready slots
+        void publish(size_t index, size_t n) noexcept;
+
+    public:
+        concurrent_vector();
+        explicit concurrent_vector(const Allocator& alloc);
+
+        // the elements can't be moved, so neither can the vector
+        concurrent_vector(const concurrent_vector<T, Allocator>&) = delete;
+        concurrent_vector<T, Allocator>& operator=(const concurrent_vector<T, Allocator>&) = delete;
+
+        ~concurrent_vector();
+
+        Allocator get_allocator() const {
+            return *this;
+        }
+
+        // the number of the published elements, the slots behind an unfinished insertion aren't counted yet
+        [[nodiscard]] size_t size() const {
+            return size_.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        // the number of the allocated slots, it may grow while it's read
+        size_t capacity() const;
+
+        // allocate the segments for n elements in advance
+        void reserve(size_t n) {
+            allocate_segments(0, n);
+        }
+
+        // it don't check the boundary, index should be below size()
+        T& operator[](size_t index) {
+            return *slot(index);
+        }
+
+        const T& operator[](size_t index) const {
+            return *slot(index);
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        T& at(size_t index) {
+            if (index >= size()) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return *slot(index);
+        }
+
+        const T& at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return *slot(index);
+        }
+
+        const T& front() const {
+            return at(0);
+        }
+
+        T& front() {
+            return at(0);
+        }
+
+        // the last published element
+        const T& back() const {
+            size_t n = size();
+            if (n == 0) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(n - 1);
+        }
+
+        T& back() {
+            size_t n = size();
+            if (n == 0) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(n - 1);
+        }
+
+        /* append an element and return a reference to it, which is valid until the vector is cleared
+           it's constructed before a slot is reserved, so a throwing constructor leaves the vector unchanged */
+        T& push_back(const T& elem) {
+            return emplace_back(elem);
+        }
+
+        T& push_back(T&& elem) {
+            return emplace_back(std::move(elem));
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args);
+
+        /* append n value-initialized elements and return the index of the first one
+           T must be nothrow default constructible since the slots are already reserved */
+        size_t grow_by(size_t n);
+
+        // append n copies of elem, T must be nothrow copy constructible
+        size_t grow_by(size_t n, const T& elem);
+
+        // destroy all the elements and keep the segments, it must not run concurrently with anything
+        void clear() noexcept;
+
+        // the iterators cover the elements published when they are created
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, size());
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size());
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <typename T, typename Allocator>
+    concurrent_vector<T, Allocator>::concurrent_vector() : reserved_(0), size_(0) {
+        for (unsigned k = 0; k < max_segments; ++k) {
+            segments_[k].store(nullptr, std::memory_order_relaxed);
+            flags_[k].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    concurrent_vector<T, Allocator>::concurrent_vector(const Allocator& alloc) :
+        Allocator(alloc), reserved_(0), size_(0) {
+        for (unsigned k = 0; k < max_segments; ++k) {
+            segments_[k].store(nullptr, std::memory_order_relaxed);
+            flags_[k].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    concurrent_vector<T, Allocator>::~concurrent_vector() {
+        clear();
+        flag_allocator flag_alloc(alloc());
+        for (unsigned k = 0; k < max_segments; ++k) {
+            T* segment = segments_[k].load(std::memory_order_relaxed);
+            if (segment) {
+                alloc_traits::deallocate(alloc(), segment, segment_size(k));
+            }
+            std::atomic<bool>* flags = flags_[k].load(std::memory_order_relaxed);
+            if (flags) {
+                flag_traits::deallocate(flag_alloc, flags, segment_size(k));
+            }
+        }
+    }
+
+    template <typename T, typename Allocator>
+    void concurrent_vector<T, Allocator>::allocate_segments(size_t begin, size_t stop) {
+        if (begin >= stop) {
+            return;
+        }
+        unsigned last = segment_of(stop - 1);
+        for (unsigned k = segment_of(begin); k <= last; ++k) {
+            // the flags are installed before the segment, so a segment seen allocated has its flags
+            if (segments_[k].load(std::memory_order_acquire)) {
+                continue;
+            }
+            if (!flags_[k].load(std::memory_order_acquire)) {
+                flag_allocator flag_alloc(alloc());
+                std::atomic<bool>* flags = flag_traits::allocate(flag_alloc, segment_size(k));
+                for (size_t i = 0; i < segment_size(k); ++i) {
+                    flag_traits::construct(flag_alloc, flags + i, false);
+                }
+                std::atomic<bool>* expected_flags = nullptr;
+                if (!flags_[k].compare_exchange_strong(expected_flags, flags, std::memory_order_acq_rel)) {
+                    flag_traits::deallocate(flag_alloc, flags, segment_size(k));
+                }
+            }
+            T* segment = alloc_traits::allocate(alloc(), segment_size(k));
+            T* expected = nullptr;
+            if (!segments_[k].compare_exchange_strong(expected, segment, std::memory_order_acq_rel)) {
+                // another thread has installed the segment
+                alloc_traits::deallocate(alloc(), segment, segment_size(k));
+            }
+        }
+    }
+
+    template <typename T, typename Allocator>
+    size_t concurrent_vector<T, Allocator>::reserve_slots(size_t n) {
+        // released, so the thread scanning the slots below reserved_ in publish sees their segments
+        size_t index = reserved_.load(std::memory_order_relaxed);
+        do {
+            allocate_segments(index, index + n);
+        } while (!reserved_.compare_exchange_weak(index, index + n, std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        return index;
+    }
+
+    template <typename T, typename Allocator>
+    void concurrent_vector<T, Allocator>::publish(size_t index, size_t n) noexcept {
+        /* the flags and size_ are accessed in sequential consistency: if the slot at size() isn't ready when
+           we scan it, its writer sets the flag after our scan, so its own scan starts at least where we stopped
+           and sees our flags. so every ready slot gets counted by its writer or by a later one */
+        for (size_t i = index; i < index + n; ++i) {
+            flag(i).store(true);
+        }
+        size_t count = size_.load();
+        while (true) {
+            size_t stop = reserved_.load();
+            size_t ready = count;
+            while (ready < stop && flag(ready).load()) {
+                ++ready;
+            }
+            if (ready == count) {
+                return;
+            }
+            // a failed exchange loads the new size into count and the scan starts again from there
+            if (size_.compare_exchange_weak(count, ready)) {
+                count = ready;
+            }
+        }
+    }
+
+    template <typename T, typename Allocator>
+    size_t concurrent_vector<T, Allocator>::capacity() const {
+        size_t cap = 0;
+        for (unsigned k = 0; k < max_segments && segments_[k].load(std::memory_order_acquire); ++k) {
+            cap = segment_begin(k) + segment_size(k);
+        }
+        return cap;
+    }
+
+    template <typename T, typename Allocator> template <typename... Args>
+    T& concurrent_vector<T, Allocator>::emplace_back(Args&&... args) {
+        static_assert(std::is_nothrow_move_constructible<T>::value,
+                      "the elements of concurrent_vector must be nothrow move constructible");
+        T temp(std::forward<Args>(args)...);
+        size_t index = reserve_slots(1);
+        T* p = slot(index);
+        alloc_traits::construct(alloc(), p, std::move(temp));
+        publish(index, 1);
+        return *p;
+    }
+
+    template <typename T, typename Allocator>
+    size_t concurrent_vector<T, Allocator>::grow_by(size_t n) {
+        static_assert(std::is_nothrow_default_constructible<T>::value,
+                      "grow_by(n) needs a nothrow default constructible T");
+        size_t index = reserve_slots(n);
+        for (size_t i = index; i < index + n; ++i) {
+            alloc_traits::construct(alloc(), slot(i));
+        }
+        publish(index, n);
+        return index;
+    }
+
+    template <typename T, typename Allocator>
+    size_t concurrent_vector<T, Allocator>::grow_by(size_t n, const T& elem) {
+        static_assert(std::is_nothrow_copy_constructible<T>::value,
+                      "grow_by(n, elem) needs a nothrow copy constructible T");
+        size_t index = reserve_slots(n);
+        for (size_t i = index; i < index + n; ++i) {
+            alloc_traits::construct(alloc(), slot(i), elem);
+        }
+        publish(index, n);
+        return index;
+    }
+
+    template <typename T, typename Allocator>
+    void concurrent_vector<T, Allocator>::clear() noexcept {
+        size_t n = size_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < n; ++i) {
+            if constexpr (!std::is_trivially_destructible<T>::value) {
+                alloc_traits::destroy(alloc(), slot(i));
+            }
+            flag(i).store(false, std::memory_order_relaxed);
+        }
+        size_.store(0, std::memory_order_relaxed);
+        reserved_.store(0, std::memory_order_relaxed);
+    }
+}
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef MTL_COW_VECTOR_H
+#define MTL_COW_VECTOR_H
+
+#include <atomic>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <mtl/vector.h>
+#include <mtl/vector_view.h>
+
+namespace mtl {
+    /* The copy-on-write vector. The copies share one reference-counted vector, so copying is O(1) and the memory
+       doesn't grow with the number of snapshots. The elements are only readable through the shared vector,
+       every modification first duplicates it unless this is the only owner.
+       The reference count is atomic, so the copies can be handed to other threads, but one cow_vector object
+       should not be modified by two threads at once. Arrays are only shared between equal allocators. */
+    template <typename T, typename Allocator = std::allocator<T>, typename Growth = double_growth>
+    class cow_vector : private Allocator {
+    public:
+        typedef vector<T, Allocator, Growth> vector_type;
+        typedef vector_const_iterator<T> const_iterator;
+        typedef const_iterator iterator;
+
+    private:
+        // the shared vector with its reference count
+        struct rep {
+            std::atomic<size_t> refs;
+            vector_type vec;
+
+            template <typename... Args>
+            explicit rep(Args&&... args) : refs(1), vec(std::forward<Args>(args)...) {}
+        };
+
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<rep> rep_allocator;
+        typedef std::allocator_traits<rep_allocator> rep_traits;
+        typedef std::allocator_traits<Allocator> alloc_traits;
+
+        // nullptr if the cow_vector is empty and has never been modified
+        rep* rep_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
+
+        // create a rep whose vector is constructed from args
+        template <typename... Args>
+        rep* create_rep(Args&&... args);
+
+        // create a rep holding a copy of the elements of vec, with the allocator of this cow_vector
+        rep* copy_rep(const vector_type& vec);
+
+        // drop the reference to the rep, it's destroyed by the last owner
+        void release() noexcept;
+
+        // make this the only owner of its rep, the shared vector is copied if there are other owners
+        void detach();
+
+        const T* data() const {
+            return rep_ ? rep_->vec.view().data() : nullptr;
+        }
+
+    public:
+        cow_vector();
+        explicit cow_vector(const Allocator& alloc);
+        cow_vector(std::initializer_list<T>&& il, const Allocator& alloc = Allocator());
+
+        // take over the elements of vec
+        explicit cow_vector(vector_type&& vec);
+
+        // share the vector of rhs in O(1)
+        cow_vector(const cow_vector<T, Allocator, Growth>& rhs);
+        cow_vector(cow_vector<T, Allocator, Growth>&& rhs) noexcept;
+
+        ~cow_vector();
+
+        cow_vector<T, Allocator, Growth>& operator=(const cow_vector<T, Allocator, Growth>& rhs);
+        // it allocates a new rep when the allocators differ and don't propagate
+        cow_vector<T, Allocator, Growth>& operator=(cow_vector<T, Allocator, Growth>&& rhs) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value);
+
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return rep_ ? rep_->vec.size() : 0;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return rep_ ? rep_->vec.capacity() : 0;
+        }
+
+        // the number of cow_vectors sharing the elements, 0 if there's no array
+        size_t use_count() const {
+            return rep_ ? rep_->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        // it don't check the boundary
+        const T& operator[](size_t index) const {
+            return data()[index];
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        const T& at(size_t index) const {
+            if (index < size()) {
+                return data()[index];
+            } else {
+                throw std::out_of_range("The index is out of range.");
+            }
+        }
+
+        const T& front() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return data()[0];
+        }
+
+        const T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return data()[size() - 1];
+        }
+
+        // return a read-only view of the elements, it's invalidated by the next modification
+        vector_view<const T> view() const {
+            return vector_view<const T>(data(), size());
+        }
+
+        /* return the vector owned by this cow_vector only, it's copied first if it's shared
+           the reference is valid until this cow_vector is copied or destroyed */
+        vector_type& edit();
+
+        // replace the element at index, it throw an out_of_range exception if index is invalid
+        void set(size_t index, const T& elem);
+
+        void push_back(const T& elem) {
+            edit().push_back(elem);
+        }
+
+        void push_back(T&& elem) {
+            edit().push_back(std::move(elem));
+        }
+
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            return edit().emplace_back(std::forward<Args>(args)...);
+        }
+
+        void pop_back() {
+            if (empty()) {
+                throw std::out_of_range("There's no element to be popped out.");
+            }
+            edit().pop_back();
+        }
+
+        void reserve(size_t new_capacity) {
+            edit().reserve(new_capacity);
+        }
+
+        // remove all the elements, a shared vector is left to the other owners without copying
+        void clear() noexcept;
+
+        const_iterator cbegin() const {
+            return const_iterator(data());
+        }
+
+        const_iterator cend() const {
+            return const_iterator(data() + size());
+        }
+
+        const_iterator begin() const {
+            return cbegin();
+        }
+
+        const_iterator end() const {
+            return cend();
+        }
+    };
+
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    typename cow_vector<T, Allocator, Growth>::rep* cow_vector<T, Allocator, Growth>::create_rep(Args&&... args) {
+        rep_allocator ra(alloc());
+        rep* p = rep_traits::allocate(ra, 1);
+        try {
+            rep_traits::construct(ra, p, std::forward<Args>(args)...);
+        } catch (...) {
+            rep_traits::deallocate(ra, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    typename cow_vector<T, Allocator, Growth>::rep* cow_vector<T, Allocator, Growth>::copy_rep(const vector_type& vec) {
+        rep* p = create_rep(alloc());
+        try {
+            p->vec.reserve(vec.size());
+            p->vec.append_range(vec);
+        } catch (...) {
+            rep_allocator ra(alloc());
+            rep_traits::destroy(ra, p);
+            rep_traits::deallocate(ra, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void cow_vector<T, Allocator, Growth>::release() noexcept {
+        if (rep_ && rep_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            rep_allocator ra(alloc());
+            rep_traits::destroy(ra, rep_);
+            rep_traits::deallocate(ra, rep_, 1);
+        }
+        rep_ = nullptr;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void cow_vector<T, Allocator, Growth>::detach() {
+        if (!rep_) {
+            rep_ = create_rep(alloc());
+            return;
+        }
+        if (rep_->refs.load(std::memory_order_acquire) == 1) {
+            return;
+        }
+        rep* p = copy_rep(rep_->vec);
+        release();
+        rep_ = p;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector() : rep_(nullptr) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector(const Allocator& alloc) : Allocator(alloc), rep_(nullptr) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector(std::initializer_list<T>&& il, const Allocator& alloc) :
+        Allocator(alloc), rep_(nullptr) {
+        rep_ = create_rep(std::move(il), this->alloc());
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector(vector_type&& vec) : Allocator(vec.get_allocator()), rep_(nullptr) {
+        rep_ = create_rep(std::move(vec));
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector(const cow_vector<T, Allocator, Growth>& rhs) :
+        Allocator(alloc_traits::select_on_container_copy_construction(rhs.alloc())), rep_(nullptr) {
+        if (!rhs.rep_) {
+            return;
+        }
+        if (alloc() == rhs.alloc()) {
+            rep_ = rhs.rep_;
+            rep_->refs.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            rep_ = copy_rep(rhs.rep_->vec);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::cow_vector(cow_vector<T, Allocator, Growth>&& rhs) noexcept :
+        Allocator(rhs.alloc()), rep_(rhs.rep_) {
+        rhs.rep_ = nullptr;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>::~cow_vector() {
+        release();
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>& cow_vector<T, Allocator, Growth>::operator=(
+        const cow_vector<T, Allocator, Growth>& rhs) {
+        if (this == &rhs || rep_ == rhs.rep_) {
+            return *this;
+        }
+
+        // the rep must be freed by the allocator which created it
+        release();
+        if (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        if (!rhs.rep_) {
+            return *this;
+        }
+        if (alloc() == rhs.alloc()) {
+            rep_ = rhs.rep_;
+            rep_->refs.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            rep_ = copy_rep(rhs.rep_->vec);
+        }
+        return *this;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    cow_vector<T, Allocator, Growth>& cow_vector<T, Allocator, Growth>::operator=(
+        cow_vector<T, Allocator, Growth>&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        release();
+        if (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        if (alloc_traits::propagate_on_container_move_assignment::value || alloc() == rhs.alloc()) {
+            rep_ = rhs.rep_;
+            rhs.rep_ = nullptr;
+        } else if (rhs.rep_) {
+            /* the rep of rhs and its array came from the other allocator, so the elements go into a rep of ours,
+               they are moved only if rhs owns them alone, the other snapshots sharing them keep theirs */
+            if (rhs.rep_->refs.load(std::memory_order_acquire) == 1) {
+                rep_ = create_rep(alloc());
+                rep_->vec.append_range(std::move(rhs.rep_->vec));
+            } else {
+                rep_ = copy_rep(rhs.rep_->vec);
+            }
+            rhs.release();
+        }
+        return *this;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    typename cow_vector<T, Allocator, Growth>::vector_type& cow_vector<T, Allocator, Growth>::edit() {
+        detach();
+        return rep_->vec;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void cow_vector<T, Allocator, Growth>::set(size_t index, const T& elem) {
+        if (index >= size()) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        // copy first in case elem refers to the shared array
+        T temp(elem);
+        edit()[index] = std::move(temp);
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void cow_vector<T, Allocator, Growth>::clear() noexcept {
+        if (rep_ && rep_->refs.load(std::memory_order_acquire) == 1) {
+            rep_->vec.clear();
+        } else {
+            release();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,335 @@
+#ifndef MTL_DELTA_VECTOR_H
+#define MTL_DELTA_VECTOR_H
+
+#include <cstdint>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <mtl/vector.h>
+#include <mtl/vector_view.h>
+
+namespace mtl {
+    template <typename T>
+    class delta_vector;
+
+    /* The iterator of delta_vector, it decodes the values one by one, so it only moves forward. */
+    template <typename T>
+    class delta_vector_iterator {
+        friend class delta_vector<T>;
+
+    private:
+        const delta_vector<T>* vec_;
+        size_t index_;
+        size_t offset_;
+        T value_;
+
+        delta_vector_iterator(const delta_vector<T>* vec, size_t index) : vec_(vec), index_(index), offset_(0), value_(0) {
+            if (index_ < vec_->size()) {
+                load();
+            }
+        }
+
+        // start decoding the block holding index_, and skip to index_
+        void load();
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        delta_vector_iterator() : vec_(nullptr), index_(0), offset_(0), value_(0) {}
+
+        // the position of the value in the vector
+        size_t index() const {
+            return index_;
+        }
+
+        const T& operator*() const {
+            return value_;
+        }
+
+        const T* operator->() const {
+            return &value_;
+        }
+
+        bool operator==(const delta_vector_iterator& itr) const {
+            return index_ == itr.index_;
+        }
+
+        bool operator!=(const delta_vector_iterator& itr) const {
+            return index_ != itr.index_;
+        }
+
+        delta_vector_iterator& operator++();
+
+        delta_vector_iterator operator++(int) {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+    };
+
+    /* The vector of a non-decreasing sequence of unsigned integers, e.g. sorted ids, stored as the differences
+       between neighbours in varint bytes (7 bits per byte, the high bit marks that more bytes follow), so small
+       gaps take one byte instead of sizeof(T).
+       The values are grouped into blocks of 128. A block starts with a skip pointer holding its first value and
+       the offset of its bytes, so a block is decoded without the ones before it, operator[] decodes at most one
+       block and lower_bound binary searches the skip pointers before decoding one block. */
+    template <typename T = std::uint64_t>
+    class delta_vector {
+        static_assert(std::is_unsigned<T>::value, "delta_vector holds unsigned integers");
+
+        friend class delta_vector_iterator<T>;
+
+    public:
+        typedef T value_type;
+        typedef delta_vector_iterator<T> const_iterator;
+        typedef const_iterator iterator;
+
+        static constexpr size_t block_size = 128;
+
+    private:
+        // the varint deltas, the first value of a block is only kept in its skip pointer
+        vector<std::uint8_t> bytes_;
+
+        // the skip pointers, the first value and the offset in bytes_ of each block
+        vector<T> firsts_;
+        vector<size_t> offsets_;
+
+        size_t size_;
+        T last_;
+
+        static T read_varint(const std::uint8_t* bytes, size_t& offset) noexcept {
+            T value = 0;
+            unsigned shift = 0;
+            std::uint8_t byte;
+            do {
+                byte = bytes[offset++];
+                value |= static_cast<T>(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            return value;
+        }
+
+        void write_varint(T value);
+
+        const std::uint8_t* bytes() const noexcept {
+            return bytes_.view().data();
+        }
+
+    public:
+        delta_vector() : size_(0), last_(0) {}
+
+        // encode the values, it throw an invalid_argument exception if they decrease
+        explicit delta_vector(vector_view<const T> values);
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        // the bytes of the deltas and the skip pointers
+        [[nodiscard]] size_t memory() const {
+            return bytes_.size() + firsts_.size() * (sizeof(T) + sizeof(size_t));
+        }
+
+        // it don't check the boundary, it decodes the block up to index
+        T operator[](size_t index) const;
+
+        // check the boundary, it throw an out_of_range exception
+        T at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return (*this)[index];
+        }
+
+        T back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return last_;
+        }
+
+        // append value, it throw an invalid_argument exception if it's smaller than the last one
+        void push_back(T value);
+
+        void clear() noexcept {
+            bytes_.clear();
+            firsts_.clear();
+            offsets_.clear();
+            size_ = 0;
+            last_ = 0;
+        }
+
+        // decode block b into out, which should have room for block_size values, return the number of values
+        size_t decode_block(size_t b, T* out) const;
+
+        // the index of the first value not less than value, size() if there's none
+        size_t lower_bound(T value) const;
+
+        bool contains(T value) const {
+            size_t i = lower_bound(value);
+            return i < size_ && (*this)[i] == value;
+        }
+
+        // the values in a vector
+        vector<T> to_vector() const;
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <typename T>
+    void delta_vector_iterator<T>::load() {
+        size_t b = index_ / delta_vector<T>::block_size;
+        value_ = vec_->firsts_[b];
+        offset_ = vec_->offsets_[b];
+        for (size_t i = b * delta_vector<T>::block_size; i < index_; ++i) {
+            value_ += delta_vector<T>::read_varint(vec_->bytes(), offset_);
+        }
+    }
+
+    template <typename T>
+    delta_vector_iterator<T>& delta_vector_iterator<T>::operator++() {
+        ++index_;
+        if (index_ < vec_->size()) {
+            if (index_ % delta_vector<T>::block_size == 0) {
+                value_ = vec_->firsts_[index_ / delta_vector<T>::block_size];
+            } else {
+                value_ += delta_vector<T>::read_varint(vec_->bytes(), offset_);
+            }
+        }
+        return *this;
+    }
+
+    template <typename T>
+    void delta_vector<T>::write_varint(T value) {
+        while (value >= 0x80) {
+            bytes_.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        bytes_.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    template <typename T>
+    delta_vector<T>::delta_vector(vector_view<const T> values) : size_(0), last_(0) {
+        for (size_t i = 0; i < values.size(); ++i) {
+            push_back(values[i]);
+        }
+    }
+
+    template <typename T>
+    T delta_vector<T>::operator[](size_t index) const {
+        size_t b = index / block_size;
+        T value = firsts_[b];
+        size_t offset = offsets_[b];
+        for (size_t i = b * block_size; i < index; ++i) {
+            value += read_varint(bytes(), offset);
+        }
+        return value;
+    }
+
+    template <typename T>
+    void delta_vector<T>::push_back(T value) {
+        if (size_ && value < last_) {
+            throw std::invalid_argument("The values of a delta_vector must not decrease.");
+        }
+        if (size_ % block_size == 0) {
+            firsts_.push_back(value);
+            try {
+                offsets_.push_back(bytes_.size());
+            } catch (...) {
+                firsts_.pop_back();
+                throw;
+            }
+        } else {
+            size_t old = bytes_.size();
+            try {
+                write_varint(value - last_);
+            } catch (...) {
+                bytes_.resize(old);
+                throw;
+            }
+        }
+        last_ = value;
+        ++size_;
+    }
+
+    template <typename T>
+    size_t delta_vector<T>::decode_block(size_t b, T* out) const {
+        size_t n = size_ - b * block_size < block_size ? size_ - b * block_size : block_size;
+        T value = firsts_[b];
+        size_t offset = offsets_[b];
+        const std::uint8_t* data = bytes();
+        out[0] = value;
+        for (size_t i = 1; i < n; ++i) {
+            value += read_varint(data, offset);
+            out[i] = value;
+        }
+        return n;
+    }
+
+    template <typename T>
+    size_t delta_vector<T>::lower_bound(T value) const {
+        if (empty() || value > last_) {
+            return size_;
+        }
+
+        // the last block starting below value, the answer is in it or at the start of the next one
+        size_t lo = 0;
+        size_t hi = firsts_.size();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (firsts_[mid] < value) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0) {
+            return 0;
+        }
+
+        size_t b = lo - 1;
+        T current = firsts_[b];
+        size_t offset = offsets_[b];
+        size_t i = b * block_size;
+        size_t stop = size_ < (b + 1) * block_size ? size_ : (b + 1) * block_size;
+        while (current < value && ++i < stop) {
+            current += read_varint(bytes(), offset);
+        }
+        return i;
+    }
+
+    template <typename T>
+    vector<T> delta_vector<T>::to_vector() const {
+        vector<T> values;
+        values.resize(size_, default_init);
+        T* out = values.view().data();
+        for (size_t b = 0; b < firsts_.size(); ++b) {
+            out += decode_block(b, out);
+        }
+        return values;
+    }
+}
+
+#endif
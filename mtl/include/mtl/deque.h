@@ -5,84 +5,79 @@
 #include <initializer_list>
 
 namespace mtl {
-    template <typename T>
+    /* The deque ADT, the elements are kept in a Container, which is a linked list by default.
+       The allocator of the deque is chosen by the container, e.g. deque<T, list<T, Allocator>>. */
+    template <typename T, typename Container = list<T>>
     class deque {
         private:
-        list<T>* data_;
+        Container data_;
 
         public:
         deque();
         deque(std::initializer_list<T>&& il) noexcept;
-        deque(const deque<T>& rhs);
-        deque(deque<T>&& rhs) noexcept;
+        deque(const deque<T, Container>& rhs);
+        deque(deque<T, Container>&& rhs) noexcept;
         explicit deque(size_t n);
-        ~deque();
+        ~deque() = default;
 
         size_t size() const {
-            return data_->size();
+            return data_.size();
         }
 
         bool empty() const {
-            return data_->empty();
+            return data_.empty();
         }
 
         void push_front(const T& elem) {
-            return data_->push_front(elem);
+            return data_.push_front(elem);
         }
         void push_front(T&& elem) noexcept {
-            return data_->push_front(std::move(elem));
+            return data_.push_front(std::move(elem));
         }
 
         void push_back(const T& elem) {
-            return data_->push_back(elem);
+            return data_.push_back(elem);
         }
         void push_back(T&& elem) noexcept {
-            return data_->push_back(std::move(elem));
+            return data_.push_back(std::move(elem));
         }
 
         void pop_front() {
-            return data_->pop_front();
+            return data_.pop_front();
         }
         void pop_back() {
-            return data_->pop_back();
+            return data_.pop_back();
         }
 
         const T& front() const {
-            return data_->front();
+            return data_.front();
         }
         const T& back() const {
-            return data_->back();
+            return data_.back();
         }
 
         T& front() {
-            return data_->front();
+            return data_.front();
         }
         T& back() {
-            return data_->back();
+            return data_.back();
         }
     };
 
-    template <typename T>
-    deque<T>::deque() : data_(new list<T>()) {}
+    template <typename T, typename Container>
+    deque<T, Container>::deque() : data_() {}
 
-    template <typename T>
-    deque<T>::deque(std::initializer_list<T>&& il) noexcept : data_(new list<T>(std::move(il))) {}
+    template <typename T, typename Container>
+    deque<T, Container>::deque(std::initializer_list<T>&& il) noexcept : data_(std::move(il)) {}
 
-    template <typename T>
-    deque<T>::deque(size_t n) : data_(new list<T>(n)) {}
+    template <typename T, typename Container>
+    deque<T, Container>::deque(size_t n) : data_(n) {}
 
-    template <typename T>
-    deque<T>::deque(const deque<T>& rhs) : data_(new list<T>(*rhs.data_)) {}
+    template <typename T, typename Container>
+    deque<T, Container>::deque(const deque<T, Container>& rhs) : data_(rhs.data_) {}
 
-    template <typename T>
-    deque<T>::deque(deque<T>&& rhs) noexcept : data_(rhs.data_) {
-        rhs.data_ = nullptr;
-    }
-
-    template <typename T>
-    deque<T>::~deque() {
-        delete data_;
-    }
+    template <typename T, typename Container>
+    deque<T, Container>::deque(deque<T, Container>&& rhs) noexcept : data_(std::move(rhs.data_)) {}
 }
 
 #endif
\ No newline at end of file
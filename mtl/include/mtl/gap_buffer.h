@@ -0,0 +1,468 @@
+#ifndef MTL_GAP_BUFFER_H
+#define MTL_GAP_BUFFER_H
+
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <mtl/growth_policy.h>
+#include <mtl/index_iterator.h>
+#include <mtl/type_traits.h>
+
+namespace mtl {
+    /* The sequence for the edits clustered around a cursor, e.g. the text of an editor. The elements are kept in
+       one array with a gap of uninitialized cells at the cursor: [0, gap_begin_) are the elements before the
+       cursor and [gap_end_, capacity_) the ones after it. Inserting or erasing at the cursor only moves the edge
+       of the gap, moving the cursor by d moves d elements across the gap (with memmove if T is trivially
+       relocatable), and the array is only reallocated by Growth when the gap is used up.
+       operator[] and the iterators skip the gap, so they see the elements as one contiguous sequence. */
+    template <typename T, typename Allocator = std::allocator<T>, typename Growth = double_growth>
+    class gap_buffer : private Allocator {
+    public:
+        typedef index_iterator<gap_buffer<T, Allocator, Growth>, T> iterator;
+        typedef index_iterator<const gap_buffer<T, Allocator, Growth>, const T> const_iterator;
+
+    private:
+        typedef std::allocator_traits<Allocator> alloc_traits;
+
+        T* data_;
+        size_t capacity_;
+
+        // the gap is [gap_begin_, gap_end_), gap_begin_ is the cursor
+        size_t gap_begin_;
+        size_t gap_end_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
+
+        size_t gap_size() const noexcept {
+            return gap_end_ - gap_begin_;
+        }
+
+        // the cell of the element at index
+        T* slot(size_t index) const noexcept {
+            return data_ + (index < gap_begin_ ? index : index + gap_size());
+        }
+
+        // move construct [first, last) into dest and destroy the originals, from front to back
+        void relocate(T* first, T* last, T* dest) noexcept;
+
+        // the same with relocate but from back to front, used when dest overlaps the tail of the source
+        void relocate_backward(T* first, T* last, T* dest_last) noexcept;
+
+        // make the gap at least n cells wide, the elements are moved into a new array by Growth
+        void widen_gap(size_t n);
+
+        // destroy the elements and free the array
+        void release() noexcept;
+
+    public:
+        gap_buffer();
+        explicit gap_buffer(const Allocator& alloc);
+        gap_buffer(std::initializer_list<T>&& il, const Allocator& alloc = Allocator());
+        gap_buffer(const gap_buffer<T, Allocator, Growth>& rhs);
+        gap_buffer(gap_buffer<T, Allocator, Growth>&& rhs) noexcept;
+
+        ~gap_buffer();
+
+        gap_buffer<T, Allocator, Growth>& operator=(const gap_buffer<T, Allocator, Growth>& rhs);
+        // it allocates a new array when the allocators differ and don't propagate, so it may throw then
+        gap_buffer<T, Allocator, Growth>& operator=(gap_buffer<T, Allocator, Growth>&& rhs) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value);
+
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return capacity_ - gap_size();
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return capacity_;
+        }
+
+        // the position of the cursor, the insertions happen before the element at it
+        size_t cursor() const {
+            return gap_begin_;
+        }
+
+        // make room for n elements in total
+        void reserve(size_t n) {
+            if (n > size()) {
+                widen_gap(n - size());
+            }
+        }
+
+        /* move the cursor to pos, the elements between the old and the new position cross the gap
+           it throw an out_of_range exception if pos is greater than size() */
+        void move_cursor(size_t pos);
+
+        // it don't check the boundary
+        const T& operator[](size_t index) const {
+            return *slot(index);
+        }
+
+        T& operator[](size_t index) {
+            return *slot(index);
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        const T& at(size_t index) const {
+            if (index < size()) {
+                return *slot(index);
+            } else {
+                throw std::out_of_range("The index is out of range.");
+            }
+        }
+
+        T& at(size_t index) {
+            return const_cast<T&>(static_cast<const gap_buffer<T, Allocator, Growth>*>(this)->at(index));
+        }
+
+        const T& front() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(0);
+        }
+
+        const T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(size() - 1);
+        }
+
+        T& front() {
+            return const_cast<T&>(static_cast<const gap_buffer<T, Allocator, Growth>*>(this)->front());
+        }
+
+        T& back() {
+            return const_cast<T&>(static_cast<const gap_buffer<T, Allocator, Growth>*>(this)->back());
+        }
+
+        // insert an element at the cursor, the cursor moves behind it
+        void insert(const T& elem) {
+            emplace(elem);
+        }
+
+        void insert(T&& elem) {
+            emplace(std::move(elem));
+        }
+
+        // construct an element at the cursor with args, the cursor moves behind it, return a reference to it
+        template <typename... Args>
+        T& emplace(Args&&... args);
+
+        // move the cursor to pos and insert an element there
+        void insert(size_t pos, const T& elem) {
+            move_cursor(pos);
+            emplace(elem);
+        }
+
+        // append an element to the end, the cursor moves to the end
+        void push_back(const T& elem) {
+            move_cursor(size());
+            emplace(elem);
+        }
+
+        void push_back(T&& elem) {
+            move_cursor(size());
+            emplace(std::move(elem));
+        }
+
+        // remove n elements before the cursor (backspace), it throw an out_of_range exception if there are fewer
+        void erase_before(size_t n = 1);
+
+        // remove n elements after the cursor (delete), it throw an out_of_range exception if there are fewer
+        void erase_after(size_t n = 1);
+
+        // move the cursor to pos and remove the element there
+        void erase(size_t pos) {
+            move_cursor(pos);
+            erase_after(1);
+        }
+
+        // destroy all the elements, the array is kept and the cursor goes to 0
+        void clear() noexcept;
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, size());
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size());
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::relocate(T* first, T* last, T* dest) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (first != last) {
+                std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), (last - first) * sizeof(T));
+            }
+            return;
+        }
+        for (; first != last; ++first, ++dest) {
+            alloc_traits::construct(alloc(), dest, std::move(*first));
+            alloc_traits::destroy(alloc(), first);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::relocate_backward(T* first, T* last, T* dest_last) noexcept {
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (first != last) {
+                std::memmove(static_cast<void*>(dest_last - (last - first)), static_cast<const void*>(first),
+                             (last - first) * sizeof(T));
+            }
+            return;
+        }
+        while (last != first) {
+            --last;
+            --dest_last;
+            alloc_traits::construct(alloc(), dest_last, std::move(*last));
+            alloc_traits::destroy(alloc(), last);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::widen_gap(size_t n) {
+        if (gap_size() >= n) {
+            return;
+        }
+        size_t new_capacity = Growth::next_capacity(capacity_, size() + n);
+        T* new_data = alloc_traits::allocate(alloc(), new_capacity);
+        size_t tail = capacity_ - gap_end_;
+        if (data_) {
+            relocate(data_, data_ + gap_begin_, new_data);
+            relocate(data_ + gap_end_, data_ + capacity_, new_data + new_capacity - tail);
+            alloc_traits::deallocate(alloc(), data_, capacity_);
+        }
+        data_ = new_data;
+        capacity_ = new_capacity;
+        gap_end_ = new_capacity - tail;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::release() noexcept {
+        clear();
+        if (data_) {
+            alloc_traits::deallocate(alloc(), data_, capacity_);
+        }
+        data_ = nullptr;
+        capacity_ = 0;
+        gap_begin_ = 0;
+        gap_end_ = 0;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::gap_buffer() : data_(nullptr), capacity_(0), gap_begin_(0), gap_end_(0) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::gap_buffer(const Allocator& alloc) :
+        Allocator(alloc), data_(nullptr), capacity_(0), gap_begin_(0), gap_end_(0) {}
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::gap_buffer(std::initializer_list<T>&& il, const Allocator& alloc) :
+        Allocator(alloc), data_(nullptr), capacity_(0), gap_begin_(0), gap_end_(0) {
+        try {
+            reserve(il.size());
+            for (auto itr = il.begin(); itr != il.end(); ++itr) {
+                emplace(*itr);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::gap_buffer(const gap_buffer<T, Allocator, Growth>& rhs) :
+        Allocator(alloc_traits::select_on_container_copy_construction(rhs.alloc())),
+        data_(nullptr), capacity_(0), gap_begin_(0), gap_end_(0) {
+        try {
+            reserve(rhs.size());
+            for (size_t i = 0; i < rhs.size(); ++i) {
+                emplace(rhs[i]);
+            }
+            move_cursor(rhs.cursor());
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::gap_buffer(gap_buffer<T, Allocator, Growth>&& rhs) noexcept :
+        Allocator(rhs.alloc()), data_(rhs.data_), capacity_(rhs.capacity_),
+        gap_begin_(rhs.gap_begin_), gap_end_(rhs.gap_end_) {
+        rhs.data_ = nullptr;
+        rhs.capacity_ = 0;
+        rhs.gap_begin_ = 0;
+        rhs.gap_end_ = 0;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>::~gap_buffer() {
+        release();
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>& gap_buffer<T, Allocator, Growth>::operator=(
+        const gap_buffer<T, Allocator, Growth>& rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        // the array must be freed by the allocator which created it
+        if (alloc_traits::propagate_on_container_copy_assignment::value && alloc() != rhs.alloc()) {
+            release();
+        }
+        if (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        clear();
+        reserve(rhs.size());
+        for (size_t i = 0; i < rhs.size(); ++i) {
+            emplace(rhs[i]);
+        }
+        move_cursor(rhs.cursor());
+        return *this;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    gap_buffer<T, Allocator, Growth>& gap_buffer<T, Allocator, Growth>::operator=(
+        gap_buffer<T, Allocator, Growth>&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        release();
+        if (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        if (alloc_traits::propagate_on_container_move_assignment::value || alloc() == rhs.alloc()) {
+            data_ = rhs.data_;
+            capacity_ = rhs.capacity_;
+            gap_begin_ = rhs.gap_begin_;
+            gap_end_ = rhs.gap_end_;
+            rhs.data_ = nullptr;
+            rhs.capacity_ = 0;
+            rhs.gap_begin_ = 0;
+            rhs.gap_end_ = 0;
+        } else {
+            // our allocator can't free the array of rhs, move its elements into a new array and keep its cursor
+            reserve(rhs.size());
+            for (size_t i = 0; i < rhs.size(); ++i) {
+                emplace(std::move(rhs[i]));
+            }
+            move_cursor(rhs.cursor());
+            rhs.release();
+        }
+        return *this;
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::move_cursor(size_t pos) {
+        if (pos > size()) {
+            throw std::out_of_range("The position is out of range.");
+        }
+        if (gap_size() == 0) {
+            // a full array has no gap to move the elements through, the cursor is only a position
+            gap_begin_ = gap_end_ = pos;
+            return;
+        }
+        if (pos < gap_begin_) {
+            // the elements in [pos, gap_begin_) go behind the gap
+            size_t n = gap_begin_ - pos;
+            relocate_backward(data_ + pos, data_ + gap_begin_, data_ + gap_end_);
+            gap_begin_ = pos;
+            gap_end_ -= n;
+        } else if (pos > gap_begin_) {
+            // the elements in front of the gap's end come before it
+            size_t n = pos - gap_begin_;
+            relocate(data_ + gap_end_, data_ + gap_end_ + n, data_ + gap_begin_);
+            gap_begin_ = pos;
+            gap_end_ += n;
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    T& gap_buffer<T, Allocator, Growth>::emplace(Args&&... args) {
+        if (gap_begin_ == gap_end_) {
+            // the arguments may refer to the elements which are about to move
+            T temp(std::forward<Args>(args)...);
+            widen_gap(1);
+            alloc_traits::construct(alloc(), data_ + gap_begin_, std::move(temp));
+        } else {
+            alloc_traits::construct(alloc(), data_ + gap_begin_, std::forward<Args>(args)...);
+        }
+        return data_[gap_begin_++];
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::erase_before(size_t n) {
+        if (n > gap_begin_) {
+            throw std::out_of_range("There are not enough elements before the cursor.");
+        }
+        for (; n; --n) {
+            alloc_traits::destroy(alloc(), data_ + --gap_begin_);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::erase_after(size_t n) {
+        if (n > capacity_ - gap_end_) {
+            throw std::out_of_range("There are not enough elements after the cursor.");
+        }
+        for (; n; --n) {
+            alloc_traits::destroy(alloc(), data_ + gap_end_++);
+        }
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void gap_buffer<T, Allocator, Growth>::clear() noexcept {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (size_t i = 0; i < gap_begin_; ++i) {
+                alloc_traits::destroy(alloc(), data_ + i);
+            }
+            for (size_t i = gap_end_; i < capacity_; ++i) {
+                alloc_traits::destroy(alloc(), data_ + i);
+            }
+        }
+        gap_begin_ = 0;
+        gap_end_ = capacity_;
+    }
+}
+
+#endif
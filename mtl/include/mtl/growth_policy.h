@@ -0,0 +1,70 @@
+#ifndef MTL_GROWTH_POLICY_H
+#define MTL_GROWTH_POLICY_H
+
+#include <cstddef>
+
+namespace mtl {
+    typedef std::size_t size_t;
+
+    /* The growth policies decide how the array-based containers expand their arrays. A policy provides
+         initial_capacity: the capacity allocated by the first insertion into an empty container
+         next_capacity(capacity, required): the new capacity when required cells are needed but only capacity exist,
+                                           it should not be smaller than required
+         retain_on_clear: whether clear() keeps the array for the next insertions or frees it */
+
+    /* multiply the capacity by Num / Den on each expansion */
+    template <size_t Num, size_t Den, size_t Initial = 128>
+    struct geometric_growth {
+        static_assert(Num > Den && Den > 0, "the capacity must grow");
+
+        static constexpr size_t initial_capacity = Initial;
+        static constexpr bool retain_on_clear = true;
+
+        static size_t next_capacity(size_t capacity, size_t required) {
+            size_t cap = capacity ? capacity / Den * Num + capacity % Den * Num / Den : Initial;
+            cap = cap > capacity ? cap : capacity + 1;
+            return cap > required ? cap : required;
+        }
+    };
+
+    // double the capacity, the default policy of the containers
+    typedef geometric_growth<2, 1> double_growth;
+
+    // multiply the capacity by 1.5, so that the freed arrays could be reused by the following expansions
+    typedef geometric_growth<3, 2> one_and_half_growth;
+
+    /* add Step cells on each expansion, it's suitable for the huge arrays whose size is predictable */
+    template <size_t Step>
+    struct fixed_step_growth {
+        static_assert(Step > 0, "the capacity must grow");
+
+        static constexpr size_t initial_capacity = Step;
+        static constexpr bool retain_on_clear = true;
+
+        static size_t next_capacity(size_t capacity, size_t required) {
+            size_t cap = capacity + Step;
+            return cap > required ? cap : (required + Step - 1) / Step * Step;
+        }
+    };
+
+    /* grow by Policy, but never add more than MaxStep cells at once
+       so that a huge array grows by fixed steps rather than doubling */
+    template <typename Policy, size_t MaxStep>
+    struct capped_growth : Policy {
+        static size_t next_capacity(size_t capacity, size_t required) {
+            size_t cap = Policy::next_capacity(capacity, required);
+            if (cap - capacity > MaxStep) {
+                cap = capacity + MaxStep;
+            }
+            return cap > required ? cap : required;
+        }
+    };
+
+    /* grow by Policy, but free the array on clear() instead of keeping it */
+    template <typename Policy>
+    struct release_on_clear : Policy {
+        static constexpr bool retain_on_clear = false;
+    };
+}
+
+#endif
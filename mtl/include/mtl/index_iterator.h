@@ -0,0 +1,136 @@
+#ifndef MTL_INDEX_ITERATOR_H
+#define MTL_INDEX_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+
+namespace mtl {
+    typedef std::size_t size_t;
+
+    /* The iterator of the containers whose elements are found by operator[] in O(1) but aren't contiguous,
+       e.g. the segmented vectors. It keeps the container and the index, so it doesn't know the segments.
+       Value is the element type, const for the const iterator, and Container is const along with it.
+       Reference is what operator[] of the container returns, a proxy object or a value for the containers which
+       don't store Value as a whole. There's nothing to point to then, so pointer is void and operator-> is only
+       declared for real references.
+       An iterator converts to the const one implicitly. */
+    template <typename Container, typename Value, typename Reference = Value&>
+    class index_iterator {
+        template <typename, typename, typename>
+        friend class index_iterator;
+
+    private:
+        Container* container_;
+        size_t index_;
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef std::remove_const_t<Value> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::conditional_t<std::is_reference<Reference>::value, Value*, void> pointer;
+        typedef Reference reference;
+
+        index_iterator() : container_(nullptr), index_(0) {}
+
+        index_iterator(Container* container, size_t index) : container_(container), index_(index) {}
+
+        // the conversion from the iterator to the const one
+        template <typename C, typename V, typename R,
+                  typename = std::enable_if_t<std::is_convertible<C*, Container*>::value>>
+        index_iterator(const index_iterator<C, V, R>& itr) : container_(itr.container_), index_(itr.index_) {}
+
+        // the position of the element in the container
+        size_t index() const {
+            return index_;
+        }
+
+        Reference operator*() const {
+            return (*container_)[index_];
+        }
+
+        template <typename R = Reference, typename = std::enable_if_t<std::is_reference<R>::value>>
+        Value* operator->() const {
+            return &(*container_)[index_];
+        }
+
+        Reference operator[](difference_type n) const {
+            return (*container_)[index_ + n];
+        }
+
+        bool operator==(const index_iterator& itr) const {
+            return index_ == itr.index_;
+        }
+
+        bool operator!=(const index_iterator& itr) const {
+            return index_ != itr.index_;
+        }
+
+        bool operator<(const index_iterator& itr) const {
+            return index_ < itr.index_;
+        }
+
+        bool operator>(const index_iterator& itr) const {
+            return index_ > itr.index_;
+        }
+
+        bool operator<=(const index_iterator& itr) const {
+            return index_ <= itr.index_;
+        }
+
+        bool operator>=(const index_iterator& itr) const {
+            return index_ >= itr.index_;
+        }
+
+        index_iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        index_iterator operator++(int) {
+            auto old = *this;
+            ++index_;
+            return old;
+        }
+
+        index_iterator& operator--() {
+            --index_;
+            return *this;
+        }
+
+        index_iterator operator--(int) {
+            auto old = *this;
+            --index_;
+            return old;
+        }
+
+        index_iterator& operator+=(difference_type n) {
+            index_ += n;
+            return *this;
+        }
+
+        index_iterator& operator-=(difference_type n) {
+            index_ -= n;
+            return *this;
+        }
+
+        index_iterator operator+(difference_type n) const {
+            return index_iterator(container_, index_ + n);
+        }
+
+        index_iterator operator-(difference_type n) const {
+            return index_iterator(container_, index_ - n);
+        }
+
+        friend index_iterator operator+(difference_type n, const index_iterator& itr) {
+            return itr + n;
+        }
+
+        // the number of elements from itr to this iterator
+        difference_type operator-(const index_iterator& itr) const {
+            return static_cast<std::ptrdiff_t>(index_) - static_cast<std::ptrdiff_t>(itr.index_);
+        }
+    };
+}
+
+#endif
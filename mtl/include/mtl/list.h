@@ -6,13 +6,19 @@
 #define MTL_LIST_H
 
 #include <mtl/algorithms.h>
+#include <cstddef>
 #include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <utility>
 
 namespace mtl {
-    typedef unsigned long long size_t;
+    typedef std::size_t size_t;
 
-    template <typename T>
-    class list {
+    /* The doubly linked list ADT with a head and a tail sentinel.
+       The nodes are allocated by Allocator rebound to the node type. */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class list : private Allocator {
         private:
         class Node {
         private:
@@ -26,7 +32,7 @@ namespace mtl {
             Node(T&& elem, Node* prev, Node* next) noexcept;
             Node(const Node& node) = delete;
 
-            ~Node();
+            ~Node() = default;
 
             const T& elem() const {
                 return elem_;
@@ -44,14 +50,25 @@ namespace mtl {
                 return !prev_;
             }
 
-            friend class list<T>;
+            friend class list;
         };
 
+        typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> node_allocator;
+        typedef std::allocator_traits<node_allocator> node_traits;
+
+        public:
         class const_iterator {
             protected:
             Node* node_;
 
             public:
+            // the member types read by std::iterator_traits, a list can only be walked step by step
+            typedef std::bidirectional_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T& reference;
+
             const_iterator();
             explicit const_iterator(Node* node);
             const_iterator(const const_iterator& ci);
@@ -75,8 +92,8 @@ namespace mtl {
                 return node_->elem();
             }
 
-            T& operator*() {
-                return const_cast<T&>(static_cast<const const_iterator*>(this)->operator*());
+            const T* operator->() const {
+                return &operator*();
             }
 
             bool operator==(const const_iterator& ci) const {
@@ -112,15 +129,16 @@ namespace mtl {
                 return old;
             }
 
-            const_iterator& operator+=(size_t n);
-            const_iterator& operator-=(size_t n);
+            // move n nodes next (previous if n is negative) in O(n)
+            const_iterator& operator+=(difference_type n);
+            const_iterator& operator-=(difference_type n);
 
-            const_iterator operator+(size_t n) {
+            const_iterator operator+(difference_type n) const {
                 auto res_itr = *this;
                 res_itr += n;
                 return res_itr;
             }
-            const_iterator operator-(size_t n) {
+            const_iterator operator-(difference_type n) const {
                 auto res_itr = *this;
                 res_itr -= n;
                 return res_itr;
@@ -130,11 +148,15 @@ namespace mtl {
                 return node_;
             }
 
-            friend class list<T>;
+            friend class list;
         };
 
         class iterator : public const_iterator {
             public:
+            typedef typename const_iterator::difference_type difference_type;
+            typedef T* pointer;
+            typedef T& reference;
+
             iterator();
             explicit iterator(Node* node);
             iterator(const iterator& itr);
@@ -151,10 +173,14 @@ namespace mtl {
                 return *this;
             }
 
-            T& operator*() {
+            T& operator*() const {
                 return const_cast<T&>(const_iterator::operator*());
             }
 
+            T* operator->() const {
+                return &operator*();
+            }
+
             iterator& operator++() {
                 const_iterator::operator++();
                 return *this;
@@ -177,42 +203,75 @@ namespace mtl {
                 return old;
             }
 
-            iterator& operator+=(size_t n) {
+            iterator& operator+=(difference_type n) {
                 const_iterator::operator+=(n);
                 return *this;
             }
-            iterator& operator-=(size_t n) {
+            iterator& operator-=(difference_type n) {
                 const_iterator::operator-=(n);
                 return *this;
             }
 
-            iterator operator+(size_t n) {
+            iterator operator+(difference_type n) const {
                 auto res_itr = *this;
                 res_itr += n;
                 return res_itr;
             }
-            iterator operator-(size_t n) {
+            iterator operator-(difference_type n) const {
                 auto res_itr = *this;
                 res_itr -= n;
                 return res_itr;
             }
         };
 
+        private:
         Node* head_;
         Node* tail_;
         size_t size_;
 
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
+
+        // allocate a node and construct it with args
+        template <typename... Args>
+        Node* create_node(Args&&... args);
+
+        // destroy a node and free its memory, the links of the node are not touched
+        void destroy_node(Node* node) noexcept;
+
+        // destroy the node and all the nodes following it
+        void destroy_chain(Node* node) noexcept;
+
+        // destroy the nodes between the sentinels, the sentinels are kept
+        void destroy_elements() noexcept;
+
         void init();
 
         public:
+        typedef Allocator allocator_type;
+
         list();
-        list(const list<T>& l);
-        list(list<T>&& l) noexcept;
-        list(std::initializer_list<T>&& init) noexcept;
+        explicit list(const Allocator& alloc);
+        list(const list<T, Allocator>& l);
+        list(list<T, Allocator>&& l) noexcept;
+        list(std::initializer_list<T>&& init, const Allocator& alloc = Allocator()) noexcept;
         ~list();
 
-        list<T>& operator=(const list<T>& l);
-        list<T>& operator=(list<T>&& l) noexcept;
+        // return a copy of the allocator
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        list<T, Allocator>& operator=(const list<T, Allocator>& l);
+        // it allocates the nodes of the elements when the allocators differ and don't propagate
+        list<T, Allocator>& operator=(list<T, Allocator>&& l) noexcept(
+            std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<Allocator>::is_always_equal::value);
 
         void clear();
 
@@ -225,9 +284,9 @@ namespace mtl {
         }
 
         void push_back(const T& elem);
-        void push_back(T&& elem) noexcept;
+        void push_back(T&& elem);
         void push_front(const T& elem);
-        void push_front(T&& elem) noexcept;
+        void push_front(T&& elem);
 
         void pop_front();
         void pop_back();
@@ -269,103 +328,145 @@ namespace mtl {
         }
     };
 
-    template <typename T>
-    list<T>::Node::Node() : elem_(), prev_(nullptr), next_(nullptr) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::Node::Node() : elem_(), next_(nullptr), prev_(nullptr) {}
 
-    template <typename T>
-    list<T>::Node::Node(const T& elem, Node* prev, Node* next) : elem_(elem), prev_(prev), next_(next) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::Node::Node(const T& elem, Node* prev, Node* next) : elem_(elem), next_(next), prev_(prev) {}
 
-    template <typename T>
-    list<T>::Node::Node(T&& elem, Node* prev, Node* next) noexcept : elem_(std::move(elem)), prev_(prev), next_(next) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::Node::Node(T&& elem, Node* prev, Node* next) noexcept : elem_(std::move(elem)), next_(next), prev_(prev) {}
 
-    template <typename T>
-    list<T>::Node::~Node() {
-        delete next_;
-    }
-
-    template <typename T>
-    list<T>::const_iterator::const_iterator(Node* node) : node_(node) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::const_iterator::const_iterator(Node* node) : node_(node) {}
 
-    template <typename T>
-    list<T>::const_iterator::const_iterator(const const_iterator& ci) : node_(ci.node_) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::const_iterator::const_iterator(const const_iterator& ci) : node_(ci.node_) {}
 
-    template <typename T>
-    list<T>::const_iterator::const_iterator(const_iterator&& ci) noexcept : node_(ci.node_) {
+    template <typename T, typename Allocator>
+    list<T, Allocator>::const_iterator::const_iterator(const_iterator&& ci) noexcept : node_(ci.node_) {
         ci.node_ = nullptr;
     }
 
-    template <typename T>
-    typename list<T>::const_iterator& list<T>::const_iterator::operator+=(size_t n) {
-        for (size_t i = 0; i < n; ++i)
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::const_iterator& list<T, Allocator>::const_iterator::operator+=(difference_type n) {
+        if (n < 0)
+            return this->operator-=(-n);
+        for (difference_type i = 0; i < n; ++i)
             this->operator++();
         return *this;
     }
 
-    template <typename T>
-    typename list<T>::const_iterator& list<T>::const_iterator::operator-=(size_t n) {
-        for (size_t i = 0; i < n; ++i)
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::const_iterator& list<T, Allocator>::const_iterator::operator-=(difference_type n) {
+        if (n < 0)
+            return this->operator+=(-n);
+        for (difference_type i = 0; i < n; ++i)
             this->operator--();
         return *this;
     }
 
-    template <typename T>
-    list<T>::iterator::iterator(Node* node) : const_iterator(node) {}
+    template <typename T, typename Allocator>
+    list<T, Allocator>::iterator::iterator(Node* node) : const_iterator(node) {}
+
+    template <typename T, typename Allocator>
+    list<T, Allocator>::iterator::iterator(const iterator& itr) : const_iterator(itr) {}
+
+    template <typename T, typename Allocator>
+    list<T, Allocator>::iterator::iterator(iterator&& itr) noexcept : const_iterator(std::move(itr)) {}
+
+    template <typename T, typename Allocator> template <typename... Args>
+    typename list<T, Allocator>::Node* list<T, Allocator>::create_node(Args&&... args) {
+        node_allocator node_alloc(alloc());
+        Node* node = node_traits::allocate(node_alloc, 1);
+        try {
+            node_traits::construct(node_alloc, node, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(node_alloc, node, 1);
+            throw;
+        }
+        return node;
+    }
 
-    template <typename T>
-    list<T>::iterator::iterator(const iterator& itr) : const_iterator(itr) {}
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::destroy_node(Node* node) noexcept {
+        node_allocator node_alloc(alloc());
+        node_traits::destroy(node_alloc, node);
+        node_traits::deallocate(node_alloc, node, 1);
+    }
 
-    template <typename T>
-    list<T>::iterator::iterator(iterator&& itr) noexcept : const_iterator(std::move(itr)) {}
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::destroy_chain(Node* node) noexcept {
+        while (node) {
+            Node* next = node->next_;
+            destroy_node(node);
+            node = next;
+        }
+    }
 
-    template <typename T>
-    void list<T>::init() {
-        head_ = new Node();
-        tail_ = new Node();
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::init() {
+        head_ = create_node();
+        tail_ = create_node();
         head_->next_ = tail_;
         tail_->prev_ = head_;
         size_ = 0;
     }
 
-    template <typename T>
-    list<T>::list() {
+    template <typename T, typename Allocator>
+    list<T, Allocator>::list() {
+        init();
+    }
+
+    template <typename T, typename Allocator>
+    list<T, Allocator>::list(const Allocator& alloc) : Allocator(alloc) {
         init();
     }
 
-    template <typename T>
-    list<T>::list(const list<T>& l) {
+    template <typename T, typename Allocator>
+    list<T, Allocator>::list(const list<T, Allocator>& l) :
+        Allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(l.alloc())) {
         init();
         for (auto itr = l.begin(); itr != l.end(); ++itr) {
             push_back(*itr);
         }
     }
 
-    template <typename T>
-    list<T>::list(list<T>&& l) noexcept : head_(l.head_), tail_(l.tail_), size_(l.size_) {
+    template <typename T, typename Allocator>
+    list<T, Allocator>::list(list<T, Allocator>&& l) noexcept :
+        Allocator(l.alloc()), head_(l.head_), tail_(l.tail_), size_(l.size_) {
         l.init();
     }
 
-    template <typename T>
-    list<T>::list(std::initializer_list<T>&& il) noexcept {
+    template <typename T, typename Allocator>
+    list<T, Allocator>::list(std::initializer_list<T>&& il, const Allocator& alloc) noexcept : Allocator(alloc) {
         init();
         for (auto itr = il.begin(); itr != il.end(); ++itr) {
             push_back(std::move(*itr));
         }
     }
 
-    template <typename T>
-    list<T>::~list() {
-        delete head_;
+    template <typename T, typename Allocator>
+    list<T, Allocator>::~list() {
+        destroy_chain(head_);
     }
 
-    template <typename T>
-    void list<T>::clear() {
-        delete head_;
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::clear() {
+        destroy_chain(head_);
         init();
     }
 
-    template <typename T>
-    list<T>& list<T>::operator=(const list<T>& l) {
-        clear();
+    template <typename T, typename Allocator>
+    list<T, Allocator>& list<T, Allocator>::operator=(const list<T, Allocator>& l) {
+        if (this == &l) {
+            return *this;
+        }
+        // the nodes must be freed by the allocator which allocated them
+        destroy_chain(head_);
+        if (std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value) {
+            alloc() = l.alloc();
+        }
         init();
         for (auto itr = l.begin(); itr != l.end(); ++itr) {
             push_back(*itr);
@@ -374,49 +475,81 @@ namespace mtl {
         return *this;
     }
 
-    template <typename T>
-    list<T>& list<T>::operator=(list<T>&& l) noexcept {
-        clear();
-        head_ = l.head_;
-        tail_ = l.tail_;
-        size_ = l.size_;
-        l.init();
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::destroy_elements() noexcept {
+        Node* node = head_->next_;
+        while (node != tail_) {
+            Node* next = node->next_;
+            destroy_node(node);
+            node = next;
+        }
+        head_->next_ = tail_;
+        tail_->prev_ = head_;
+        size_ = 0;
+    }
+
+    template <typename T, typename Allocator>
+    list<T, Allocator>& list<T, Allocator>::operator=(list<T, Allocator>&& l) noexcept(
+        std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Allocator>::is_always_equal::value) {
+        if (this == &l) {
+            return *this;
+        }
+        destroy_elements();
+        if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value || alloc() == l.alloc()) {
+            /* take over the nodes of l and leave our empty sentinels to it, so nothing is allocated. the allocators
+               are swapped along when they propagate, l keeps the one which allocated the sentinels */
+            if (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value) {
+                using std::swap;
+                swap(alloc(), l.alloc());
+            }
+            std::swap(head_, l.head_);
+            std::swap(tail_, l.tail_);
+            std::swap(size_, l.size_);
+            return *this;
+        }
+        // the nodes belong to another allocator, move the elements one by one into nodes of ours
+        for (auto itr = l.begin(); itr != l.end(); ++itr) {
+            push_back(std::move(*itr));
+        }
+        l.destroy_elements();
+        return *this;
     }
 
-    template <typename T>
-    void list<T>::push_back(const T& elem) {
-        Node* node = new Node(elem, tail_->prev_, tail_);
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::push_back(const T& elem) {
+        Node* node = create_node(elem, tail_->prev_, tail_);
         tail_->prev_->next_ = node;
         tail_->prev_ = node;
         ++size_;
     }
 
-    template <typename T>
-    void list<T>::push_back(T&& elem) noexcept {
-        Node* node = new Node(std::move(elem), tail_->prev_, tail_);
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::push_back(T&& elem) {
+        Node* node = create_node(std::move(elem), tail_->prev_, tail_);
         tail_->prev_->next_ = node;
         tail_->prev_ = node;
         ++size_;
     }
 
-    template <typename T>
-    void list<T>::push_front(const T& elem) {
-        Node* node = new Node(elem, head_, head_->next_);
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::push_front(const T& elem) {
+        Node* node = create_node(elem, head_, head_->next_);
         head_->next_->prev_ = node;
         head_->next_ = node;
         ++size_;
     }
 
-    template <typename T>
-    void list<T>::push_front(T&& elem) noexcept {
-        Node* node = new Node(elem, head_, head_->next_);
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::push_front(T&& elem) {
+        Node* node = create_node(std::move(elem), head_, head_->next_);
         head_->next_->prev_ = node;
         head_->next_ = node;
         ++size_;
     }
 
-    template <typename T>
-    void list<T>::pop_back() {
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::pop_back() {
         if (empty()) {
             throw std::out_of_range("There's no element to be popped out.");
         }
@@ -426,11 +559,11 @@ namespace mtl {
         tail_->prev_ = node->prev_;
         node->prev_ = node->next_ = nullptr;
         --size_;
-        delete node;
+        destroy_node(node);
     }
 
-    template <typename T>
-    void list<T>::pop_front() {
+    template <typename T, typename Allocator>
+    void list<T, Allocator>::pop_front() {
         if (empty()) {
             throw std::out_of_range("There's no element to e popped out.");
         }
@@ -440,29 +573,29 @@ namespace mtl {
         head_->next_ = node->next_;
         node->prev_ = node->next_ = nullptr;
         --size_;
-        delete node;
+        destroy_node(node);
     }
 
-    template <typename T>
-    typename list<T>::iterator list<T>::insert(iterator itr, const T& elem) {
-        Node* new_node = new Node(elem, itr.node_->prev_, itr.node_);
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::iterator list<T, Allocator>::insert(iterator itr, const T& elem) {
+        Node* new_node = create_node(elem, itr.node_->prev_, itr.node_);
         itr.node_->prev_->next_ = new_node;
         itr.node_->prev_ = new_node;
         ++size_;
         return itr;
     }
 
-    template <typename T>
-    typename list<T>::iterator list<T>::insert(iterator itr, T&& elem) {
-        Node* new_node = new Node(std::move(elem), itr.node_->prev_, itr.node_);
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::iterator list<T, Allocator>::insert(iterator itr, T&& elem) {
+        Node* new_node = create_node(std::move(elem), itr.node_->prev_, itr.node_);
         itr.node_->prev_->next_ = new_node;
         itr.node_->prev_ = new_node;
         ++size_;
         return itr;       
     }
 
-    template <typename T>
-    typename list<T>::iterator list<T>::remove(iterator itr) {
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::iterator list<T, Allocator>::remove(iterator itr) {
         if (itr.node_->is_head() || itr.node_->is_tail()) {
             throw std::out_of_range("This iterator had tried to remove a nonexisting element.");
         }
@@ -472,13 +605,13 @@ namespace mtl {
         node->prev_->next_ = node->next_;
         node->next_->prev_ = node->prev_;
         node->prev_ = node->next_ = nullptr;
-        delete node;
+        destroy_node(node);
         --size_;
         return itr;
     }
 
-    template <typename T>
-    typename list<T>::iterator list<T>::remove(iterator start, iterator stop) {
+    template <typename T, typename Allocator>
+    typename list<T, Allocator>::iterator list<T, Allocator>::remove(iterator start, iterator stop) {
         if (start == stop) {
             return stop;
         }
@@ -487,13 +620,13 @@ namespace mtl {
         stop.node_->prev_->next_ = nullptr;
         stop.node_->prev_ = start.node_->prev_;
         start.node_->prev_ = nullptr;
-        delete start.node_;
+        destroy_chain(start.node_);
         return stop;
     }
 
-    template <typename T> 
+    template <typename T, typename Allocator> 
     template <typename InputIterator>
-    typename list<T>::iterator list<T>::insert(iterator itr, InputIterator start, InputIterator stop) {
+    typename list<T, Allocator>::iterator list<T, Allocator>::insert(iterator itr, InputIterator start, InputIterator stop) {
         for (auto in_itr = start; in_itr != stop; ++in_itr) {
             itr = insert(itr, *in_itr);
         }
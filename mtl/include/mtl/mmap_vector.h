@@ -0,0 +1,404 @@
+#ifndef MTL_MMAP_VECTOR_H
+#define MTL_MMAP_VECTOR_H
+
+#include <cerrno>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <mtl/growth_policy.h>
+#include <mtl/vector_iterator.h>
+#include <mtl/vector_view.h>
+
+namespace mtl {
+    /* The vector whose elements live in a file mapped into the memory, so the dataset can be larger than the RAM
+       and the kernel pages it in and out on demand. When the capacity runs out the file is extended by ftruncate
+       and remapped (by mremap on Linux, so the pages are never copied), and it's truncated to the elements when
+       the vector is destroyed, so opening the same file again restores them.
+       The bytes in the file are the objects, so only the trivially copyable types can be stored.
+       It provides the same iterators as vector, so the algorithms work on it as well. */
+    template <typename T, typename Growth = double_growth>
+    class mmap_vector {
+        static_assert(std::is_trivially_copyable<T>::value, "mmap_vector can only store trivially copyable types");
+
+    public:
+        typedef vector_const_iterator<T> const_iterator;
+        typedef vector_iterator<T> iterator;
+
+        // the access patterns told to the kernel by advise()
+        enum class access {
+            normal,       // the default read-ahead
+            sequential,   // read ahead aggressively and drop the pages soon after they are read
+            random,       // don't read ahead
+            willneed,     // start reading the pages in now
+            dontneed      // the pages can be dropped, they are read from the file again when accessed
+        };
+
+    private:
+        int fd_;
+        T* data_;
+        size_t size_;
+        size_t capacity_;
+        access pattern_;   // the last lasting pattern, it's applied again after remapping
+
+        // throw a system_error for the last failed system call
+        [[noreturn]] static void throw_errno(const char* what);
+
+        static int advice_of(access pattern) noexcept;
+
+        // resize the file and the mapping to cap elements
+        void remap(size_t cap);
+
+        // unmap the file, truncate it to the elements and close it
+        void close() noexcept;
+
+    public:
+        /* open the file at path, it's created if it doesn't exist
+           the elements in the file are loaded, unless truncate is true in which case the file is emptied */
+        explicit mmap_vector(const std::string& path, bool truncate = false);
+
+        mmap_vector(const mmap_vector<T, Growth>&) = delete;
+
+        mmap_vector(mmap_vector<T, Growth>&& vec) noexcept;
+
+        ~mmap_vector();
+
+        mmap_vector<T, Growth>& operator=(const mmap_vector<T, Growth>&) = delete;
+
+        mmap_vector<T, Growth>& operator=(mmap_vector<T, Growth>&& vec) noexcept;
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return capacity_;
+        }
+
+        // it don't check the boundary
+        const T& operator[](size_t index) const {
+            return data_[index];
+        }
+
+        T& operator[](size_t index) {
+            return data_[index];
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        const T& at(size_t index) const;
+
+        T& at(size_t index);
+
+        const T& front() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return data_[0];
+        }
+
+        const T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return data_[size_ - 1];
+        }
+
+        T& front() {
+            return const_cast<T&>(static_cast<const mmap_vector<T, Growth>*>(this)->front());
+        }
+
+        T& back() {
+            return const_cast<T&>(static_cast<const mmap_vector<T, Growth>*>(this)->back());
+        }
+
+        // return a view of all the elements, it's invalidated when the file is remapped
+        vector_view<T> view() noexcept {
+            return vector_view<T>(data_, size_);
+        }
+
+        vector_view<const T> view() const noexcept {
+            return vector_view<const T>(data_, size_);
+        }
+
+        // append an element, the file is extended by Growth if it's full
+        void push_back(const T& elem);
+
+        // remove the last element, the file keeps its length until shrink() or the destruction
+        void pop_back();
+
+        // remove all the elements, the file keeps its length
+        void clear() noexcept {
+            size_ = 0;
+        }
+
+        // extend the file for new_capacity elements, nothing happens if the capacity is enough
+        void expand(size_t new_capacity);
+
+        // truncate the file to the elements
+        void shrink();
+
+        // write the dirty pages of the elements back to the file and wait for them
+        void sync();
+
+        // tell the kernel how the whole file will be accessed
+        void advise(access pattern);
+
+        // tell the kernel how the elements [begin, stop) will be accessed, the pattern doesn't outlive a remap
+        void advise(access pattern, size_t begin, size_t stop);
+
+        const_iterator cbegin() const {
+            return const_iterator(data_);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(data_ + size_);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(data_);
+        }
+
+        const_iterator end() const {
+            return const_iterator(data_ + size_);
+        }
+
+        iterator begin() {
+            return iterator(data_);
+        }
+
+        iterator end() {
+            return iterator(data_ + size_);
+        }
+    };
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::throw_errno(const char* what) {
+        throw std::system_error(errno, std::generic_category(), what);
+    }
+
+    template <typename T, typename Growth>
+    int mmap_vector<T, Growth>::advice_of(access pattern) noexcept {
+        switch (pattern) {
+            case access::sequential:
+                return MADV_SEQUENTIAL;
+            case access::random:
+                return MADV_RANDOM;
+            case access::willneed:
+                return MADV_WILLNEED;
+            case access::dontneed:
+                return MADV_DONTNEED;
+            default:
+                return MADV_NORMAL;
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::remap(size_t cap) {
+        size_t old_bytes = capacity_ * sizeof(T);
+        size_t new_bytes = cap * sizeof(T);
+
+        // extend the file first so that the new pages are backed when they are mapped
+        if (cap > capacity_ && ftruncate(fd_, static_cast<off_t>(new_bytes)) == -1) {
+            throw_errno("mmap_vector can't extend the file");
+        }
+
+        void* p = nullptr;
+        if (cap == 0) {
+            munmap(data_, old_bytes);
+        } else if (!data_) {
+            p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        } else {
+#if defined(__linux__)
+            p = mremap(data_, old_bytes, new_bytes, MREMAP_MAYMOVE);
+#else
+            p = mmap(nullptr, new_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (p != MAP_FAILED) {
+                munmap(data_, old_bytes);
+            }
+#endif
+        }
+        if (p == MAP_FAILED) {
+            throw_errno("mmap_vector can't map the file");
+        }
+        data_ = static_cast<T*>(p);
+
+        // cut the file after the mapping no longer covers the dropped pages
+        if (cap < capacity_ && ftruncate(fd_, static_cast<off_t>(new_bytes)) == -1) {
+            capacity_ = cap;
+            throw_errno("mmap_vector can't truncate the file");
+        }
+        capacity_ = cap;
+
+        if (data_ && pattern_ != access::normal) {
+            madvise(data_, new_bytes, advice_of(pattern_));
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::close() noexcept {
+        if (fd_ == -1) {
+            return;
+        }
+        if (data_) {
+            munmap(data_, capacity_ * sizeof(T));
+        }
+        (void) ftruncate(fd_, static_cast<off_t>(size_ * sizeof(T)));
+        ::close(fd_);
+        fd_ = -1;
+        data_ = nullptr;
+        size_ = capacity_ = 0;
+    }
+
+    template <typename T, typename Growth>
+    mmap_vector<T, Growth>::mmap_vector(const std::string& path, bool truncate) :
+        fd_(-1), data_(nullptr), size_(0), capacity_(0), pattern_(access::normal) {
+        fd_ = open(path.c_str(), O_RDWR | O_CREAT | (truncate ? O_TRUNC : 0), 0644);
+        if (fd_ == -1) {
+            throw_errno("mmap_vector can't open the file");
+        }
+
+        struct stat st{};
+        if (fstat(fd_, &st) == -1) {
+            int err = errno;
+            ::close(fd_);
+            throw std::system_error(err, std::generic_category(), "mmap_vector can't stat the file");
+        }
+
+        // a partial element at the end of the file is dropped when the vector is closed
+        size_t n = static_cast<size_t>(st.st_size) / sizeof(T);
+        if (n) {
+            void* p = mmap(nullptr, n * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+            if (p == MAP_FAILED) {
+                int err = errno;
+                ::close(fd_);
+                throw std::system_error(err, std::generic_category(), "mmap_vector can't map the file");
+            }
+            data_ = static_cast<T*>(p);
+            size_ = capacity_ = n;
+        }
+    }
+
+    template <typename T, typename Growth>
+    mmap_vector<T, Growth>::mmap_vector(mmap_vector<T, Growth>&& vec) noexcept :
+        fd_(vec.fd_), data_(vec.data_), size_(vec.size_), capacity_(vec.capacity_), pattern_(vec.pattern_) {
+        vec.fd_ = -1;
+        vec.data_ = nullptr;
+        vec.size_ = vec.capacity_ = 0;
+    }
+
+    template <typename T, typename Growth>
+    mmap_vector<T, Growth>::~mmap_vector() {
+        close();
+    }
+
+    template <typename T, typename Growth>
+    mmap_vector<T, Growth>& mmap_vector<T, Growth>::operator=(mmap_vector<T, Growth>&& vec) noexcept {
+        if (this != &vec) {
+            close();
+            fd_ = vec.fd_;
+            data_ = vec.data_;
+            size_ = vec.size_;
+            capacity_ = vec.capacity_;
+            pattern_ = vec.pattern_;
+            vec.fd_ = -1;
+            vec.data_ = nullptr;
+            vec.size_ = vec.capacity_ = 0;
+        }
+        return *this;
+    }
+
+    template <typename T, typename Growth>
+    const T& mmap_vector<T, Growth>::at(size_t index) const {
+        if (index < size_) {
+            return data_[index];
+        } else {
+            throw std::out_of_range("The index is out of range.");
+        }
+    }
+
+    template <typename T, typename Growth>
+    T& mmap_vector<T, Growth>::at(size_t index) {
+        return const_cast<T&>(static_cast<const mmap_vector<T, Growth>*>(this)->at(index));
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::push_back(const T& elem) {
+        if (size_ == capacity_) {
+            // elem may live in the mapping which is about to move
+            T temp(elem);
+            remap(Growth::next_capacity(capacity_, size_ + 1));
+            new (data_ + size_) T(temp);
+        } else {
+            new (data_ + size_) T(elem);
+        }
+        ++size_;
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::pop_back() {
+        if (empty()) {
+            throw std::out_of_range("There's no element to be popped out.");
+        }
+        --size_;
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::expand(size_t new_capacity) {
+        if (new_capacity > capacity_) {
+            remap(new_capacity);
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::shrink() {
+        if (size_ < capacity_) {
+            remap(size_);
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::sync() {
+        if (size_ && msync(data_, size_ * sizeof(T), MS_SYNC) == -1) {
+            throw_errno("mmap_vector can't sync the file");
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::advise(access pattern) {
+        if (pattern != access::willneed && pattern != access::dontneed) {
+            pattern_ = pattern;
+        }
+        if (data_ && madvise(data_, capacity_ * sizeof(T), advice_of(pattern)) == -1) {
+            throw_errno("mmap_vector can't advise the kernel");
+        }
+    }
+
+    template <typename T, typename Growth>
+    void mmap_vector<T, Growth>::advise(access pattern, size_t begin, size_t stop) {
+        if (stop > size_) {
+            stop = size_;
+        }
+        if (begin >= stop) {
+            return;
+        }
+
+        // madvise takes whole pages, the mapping itself starts at a page boundary
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        size_t first = begin * sizeof(T) / page * page;
+        size_t last = stop * sizeof(T);
+        if (madvise(reinterpret_cast<char*>(data_) + first, last - first, advice_of(pattern)) == -1) {
+            throw_errno("mmap_vector can't advise the kernel");
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,250 @@
+#ifndef MTL_PACKED_VECTOR_H
+#define MTL_PACKED_VECTOR_H
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <mtl/index_iterator.h>
+#include <mtl/vector.h>
+#include <mtl/vector_view.h>
+
+namespace mtl {
+    /* The vector of unsigned integers which only keeps the low Bits bits of each, packed one after another into
+       64-bit words, e.g. 12-bit values take 12 / 32 of a vector<uint32_t>. Value i occupies bits
+       [i * Bits, (i + 1) * Bits) and may cross a word boundary, so a read is a shift, a mask and sometimes an
+       or with the next word, which keeps random access O(1).
+       T is the type the values are read as, a value which doesn't fit in Bits bits is rejected. */
+    template <unsigned Bits, typename T = std::uint64_t>
+    class packed_vector {
+        static_assert(std::is_unsigned<T>::value, "packed_vector holds unsigned integers");
+        static_assert(Bits > 0 && Bits <= sizeof(T) * 8 && Bits <= 64, "Bits must fit in T");
+
+    public:
+        typedef T value_type;
+        typedef index_iterator<const packed_vector<Bits, T>, const T, T> const_iterator;
+        typedef const_iterator iterator;
+
+        static constexpr unsigned bits = Bits;
+        static constexpr T max_value = static_cast<T>(Bits == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << Bits) - 1);
+
+    private:
+        typedef std::uint64_t word_type;
+
+        static constexpr size_t word_bits = 64;
+        static constexpr word_type mask = Bits == 64 ? ~word_type(0) : (word_type(1) << Bits) - 1;
+
+        // the values repeat their layout every lcm(Bits, 64) bits, a cycle of cycle_words words
+        static constexpr size_t cycle_values = std::lcm(size_t(Bits), word_bits) / Bits;
+        static constexpr size_t cycle_words = std::lcm(size_t(Bits), word_bits) / word_bits;
+
+        // one more word than the values need, so a read can always take the next word
+        vector<word_type> words_;
+        size_t size_;
+
+        const word_type* words() const noexcept {
+            return words_.view().data();
+        }
+
+        word_type* words() noexcept {
+            return words_.view().data();
+        }
+
+        void check_value(T value) const {
+            if (value > max_value) {
+                throw std::out_of_range("The value doesn't fit in the bits.");
+            }
+        }
+
+        // write value at index, the words should be allocated and value should fit
+        void store(size_t index, word_type value) noexcept;
+
+    public:
+        packed_vector() : size_(0) {}
+
+        // n values which are all value
+        explicit packed_vector(size_t n, T value = 0);
+
+        // pack the values, it throw an out_of_range exception if one doesn't fit
+        explicit packed_vector(vector_view<const T> values);
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        // the bytes of the packed words
+        [[nodiscard]] size_t memory() const {
+            return words_.size() * sizeof(word_type);
+        }
+
+        void reserve(size_t n) {
+            words_.reserve(n * Bits / word_bits + 2);
+        }
+
+        // it don't check the boundary
+        T operator[](size_t index) const {
+            size_t pos = index * Bits;
+            size_t w = pos / word_bits;
+            unsigned offset = pos % word_bits;
+            word_type value = words()[w] >> offset;
+            if (offset + Bits > word_bits) {
+                value |= words()[w + 1] << (word_bits - offset);
+            }
+            return static_cast<T>(value & mask);
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        T at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return (*this)[index];
+        }
+
+        // replace the value at index, it throw an out_of_range exception if index is invalid or value doesn't fit
+        void set(size_t index, T value);
+
+        void push_back(T value);
+
+        void pop_back();
+
+        void clear() noexcept {
+            words_.clear();
+            size_ = 0;
+        }
+
+        /* decode the n values from first into out, it throw an out_of_range exception if they are not all in the
+           vector. The words are unpacked a cycle of lcm(Bits, 64) bits at a time, e.g. 3 words into 16 values for
+           Bits = 12, by a loop with a fixed trip count and constant shifts, which the compiler unrolls and
+           vectorizes. */
+        void unpack(size_t first, size_t n, T* out) const;
+
+        // the values in a vector
+        vector<T> to_vector() const;
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <unsigned Bits, typename T>
+    void packed_vector<Bits, T>::store(size_t index, word_type value) noexcept {
+        size_t pos = index * Bits;
+        size_t w = pos / word_bits;
+        unsigned offset = pos % word_bits;
+        word_type* data = words();
+        data[w] = (data[w] & ~(mask << offset)) | (value << offset);
+        if (offset + Bits > word_bits) {
+            unsigned spill = word_bits - offset;
+            data[w + 1] = (data[w + 1] & ~(mask >> spill)) | (value >> spill);
+        }
+    }
+
+    template <unsigned Bits, typename T>
+    packed_vector<Bits, T>::packed_vector(size_t n, T value) : size_(0) {
+        check_value(value);
+        words_.resize(n * Bits / word_bits + 2);
+        size_ = n;
+        if (value) {
+            for (size_t i = 0; i < n; ++i) {
+                store(i, value);
+            }
+        }
+    }
+
+    template <unsigned Bits, typename T>
+    packed_vector<Bits, T>::packed_vector(vector_view<const T> values) : size_(0) {
+        words_.resize(values.size() * Bits / word_bits + 2);
+        for (size_t i = 0; i < values.size(); ++i) {
+            check_value(values[i]);
+            store(i, values[i]);
+        }
+        size_ = values.size();
+    }
+
+    template <unsigned Bits, typename T>
+    void packed_vector<Bits, T>::set(size_t index, T value) {
+        if (index >= size_) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        check_value(value);
+        store(index, value);
+    }
+
+    template <unsigned Bits, typename T>
+    void packed_vector<Bits, T>::push_back(T value) {
+        check_value(value);
+        // the value may reach the word after the one it starts in
+        size_t needed = (size_ + 1) * Bits / word_bits + 2;
+        if (words_.size() < needed) {
+            words_.resize(needed);
+        }
+        store(size_, value);
+        ++size_;
+    }
+
+    template <unsigned Bits, typename T>
+    void packed_vector<Bits, T>::pop_back() {
+        if (empty()) {
+            throw std::out_of_range("There's no element to be popped out.");
+        }
+        // clear the bits, so that a later push_back only needs to or
+        --size_;
+        store(size_, 0);
+    }
+
+    template <unsigned Bits, typename T>
+    void packed_vector<Bits, T>::unpack(size_t first, size_t n, T* out) const {
+        if (first > size_ || n > size_ - first) {
+            throw std::out_of_range("The range is out of the vector.");
+        }
+        size_t i = first;
+        size_t stop = first + n;
+        // the values before the next cycle
+        for (; i < stop && i % cycle_values; ++i) {
+            *out++ = (*this)[i];
+        }
+        const word_type* w = words() + i / cycle_values * cycle_words;
+        for (; stop - i >= cycle_values; i += cycle_values, w += cycle_words, out += cycle_values) {
+            // a value crossing a word boundary inside the cycle takes its high bits from the next word
+            for (size_t k = 0; k < cycle_values; ++k) {
+                size_t word = k * Bits / word_bits;
+                size_t shift = k * Bits % word_bits;
+                word_type value = w[word] >> shift;
+                if (shift + Bits > word_bits) {
+                    value |= w[word + 1] << (word_bits - shift);
+                }
+                out[k] = static_cast<T>(value & mask);
+            }
+        }
+        for (; i < stop; ++i) {
+            *out++ = (*this)[i];
+        }
+    }
+
+    template <unsigned Bits, typename T>
+    vector<T> packed_vector<Bits, T>::to_vector() const {
+        vector<T> values;
+        values.resize(size_, default_init);
+        unpack(0, size_, values.view().data());
+        return values;
+    }
+}
+
+#endif
@@ -0,0 +1,223 @@
+#ifndef MTL_PARALLEL_SORT_H
+#define MTL_PARALLEL_SORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <random>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <mtl/algorithms.h>
+#include <mtl/type_traits.h>
+#include <mtl/vector.h>
+
+namespace mtl {
+    // the ranges shorter than it are sorted by pdqsort in the calling thread
+    inline constexpr size_t parallel_sort_threshold = size_t(1) << 16;
+
+    // each thread gets at least this many elements, so the small ranges don't start the threads for nothing
+    inline constexpr size_t parallel_sort_min_per_thread = size_t(1) << 14;
+
+    // the buckets per thread, the more buckets the better the sorting work is balanced among the threads
+    inline constexpr size_t parallel_sort_buckets_per_thread = 4;
+
+    // the samples per bucket, the more samples the closer the buckets are in size
+    inline constexpr size_t parallel_sort_oversampling = 32;
+
+    /* sort the random access range [begin, end) in ascending order with threads threads (0 for all the hardware
+       threads) by samplesort:
+       - the splitters are picked from a sorted random sample, 4 buckets per thread,
+       - every thread classifies a part of the range into the buckets by binary search and counts them,
+       - every thread moves its elements to the places of their buckets in a scratch buffer,
+       - the buckets are taken by the threads one by one, sorted by pdqsort and moved back.
+       every splitter has a bucket of the elements equal to it, which needn't be sorted, so the ranges
+       with many duplicates keep the buckets balanced.
+       the ranges shorter than parallel_sort_threshold are sorted by pdqsort in the calling thread.
+       the elements should be copyable (the samples are copied), and the comparisons shouldn't throw */
+    template <typename Iterator>
+    void parallel_sort(Iterator begin, Iterator end, size_t threads = 0);
+
+    /* run fn(i) for i in [0, threads), fn(0) in the calling thread and the others in new threads.
+       the parts whose threads can't be started run in the calling thread after fn(0), and the started
+       threads are joined before an exception of the calling thread propagates */
+    template <typename Fn>
+    void parallel_run(size_t threads, Fn fn) {
+        vector<std::thread> workers;
+        size_t started = 1;
+        try {
+            // push_back doesn't reallocate after reserve, so a started thread is never lost
+            workers.reserve(threads - 1);
+            for (; started < threads; ++started) {
+                workers.push_back(std::thread(fn, started));
+            }
+        } catch (...) {
+            // the parts without their threads run in the calling thread
+        }
+        try {
+            fn(0);
+            for (size_t i = started; i < threads; ++i) {
+                fn(i);
+            }
+        } catch (...) {
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            throw;
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // the uninitialized storage of n elements, the elements are constructed and destroyed by the user
+    template <typename T>
+    class parallel_sort_buffer {
+    private:
+        T* data_;
+        size_t n_;
+
+    public:
+        explicit parallel_sort_buffer(size_t n) : data_(std::allocator<T>().allocate(n)), n_(n) {}
+
+        parallel_sort_buffer(const parallel_sort_buffer&) = delete;
+        parallel_sort_buffer& operator=(const parallel_sort_buffer&) = delete;
+
+        ~parallel_sort_buffer() {
+            std::allocator<T>().deallocate(data_, n_);
+        }
+
+        T* data() const noexcept {
+            return data_;
+        }
+    };
+
+    template <typename Iterator>
+    void parallel_sort(Iterator begin, Iterator end, size_t threads) {
+        static_assert(is_random_access_iterator_v<Iterator>, "parallel_sort needs the random access iterators");
+        typedef typename std::iterator_traits<Iterator>::value_type T;
+
+        size_t n = static_cast<size_t>(end - begin);
+        if (threads == 0) {
+            threads = std::thread::hardware_concurrency();
+        }
+        if (threads > n / parallel_sort_min_per_thread) {
+            threads = n / parallel_sort_min_per_thread;
+        }
+        if (n < parallel_sort_threshold || threads <= 1) {
+            mtl::pdqsort(begin, end);
+            return;
+        }
+
+        // the bucket ids are kept in 16 bits
+        if (threads > 4096) {
+            threads = 4096;
+        }
+
+        // the splitters are every oversampling-th element of the sorted sample, without duplicates
+        size_t num_buckets = threads * parallel_sort_buckets_per_thread;
+        size_t num_samples = num_buckets * parallel_sort_oversampling;
+        vector<T> samples;
+        samples.reserve(num_samples);
+        std::minstd_rand random(static_cast<std::minstd_rand::result_type>(n));
+        std::uniform_int_distribution<size_t> position(0, n - 1);
+        for (size_t i = 0; i < num_samples; ++i) {
+            samples.push_back(begin[position(random)]);
+        }
+        mtl::pdqsort(samples.begin(), samples.end());
+        vector<T> splitters;
+        splitters.reserve(num_buckets - 1);
+        for (size_t i = 1; i < num_buckets; ++i) {
+            const T& splitter = samples[i * parallel_sort_oversampling];
+            if (splitters.empty() || splitters.back() < splitter) {
+                splitters.push_back(splitter);
+            }
+        }
+
+        // bucket 2 * i holds the elements between splitters[i - 1] and splitters[i], bucket 2 * i + 1 the ones
+        // equal to splitters[i]
+        size_t num_splitters = splitters.size();
+        num_buckets = 2 * num_splitters + 1;
+        auto classify = [&splitters, num_splitters](const T& elem) -> std::uint16_t {
+            size_t lo = 0;
+            size_t hi = num_splitters;
+            while (lo < hi) {
+                size_t mid = lo + (hi - lo) / 2;
+                if (elem < splitters[mid]) {
+                    hi = mid;
+                } else {
+                    lo = mid + 1;
+                }
+            }
+            // lo is the first splitter greater than elem, elem isn't less than the one before it
+            if (lo > 0 && !(splitters[lo - 1] < elem)) {
+                return static_cast<std::uint16_t>(2 * lo - 1);
+            }
+            return static_cast<std::uint16_t>(2 * lo);
+        };
+
+        // classify the part of each thread and count its buckets
+        vector<std::uint16_t> ids;
+        ids.resize(n, default_init);
+        vector<size_t> counts;
+        counts.resize(threads * num_buckets);
+        std::uint16_t* ids_data = ids.view().data();
+        size_t* counts_data = counts.view().data();
+        auto part_begin = [n, threads](size_t t) {
+            return n / threads * t + (t < n % threads ? t : n % threads);
+        };
+        mtl::parallel_run(threads, [&](size_t t) {
+            size_t* count = counts_data + t * num_buckets;
+            for (size_t i = part_begin(t), stop = part_begin(t + 1); i < stop; ++i) {
+                std::uint16_t id = classify(begin[i]);
+                ids_data[i] = id;
+                ++count[id];
+            }
+        });
+
+        // where the elements of each thread go in each bucket, the threads fill a bucket in their order
+        vector<size_t> bucket_starts;
+        bucket_starts.resize(num_buckets + 1);
+        size_t sum = 0;
+        for (size_t b = 0; b < num_buckets; ++b) {
+            bucket_starts[b] = sum;
+            for (size_t t = 0; t < threads; ++t) {
+                size_t count = counts_data[t * num_buckets + b];
+                counts_data[t * num_buckets + b] = sum;
+                sum += count;
+            }
+        }
+        bucket_starts[num_buckets] = sum;
+
+        // move the elements to their buckets in the buffer
+        parallel_sort_buffer<T> buffer(n);
+        T* buf = buffer.data();
+        mtl::parallel_run(threads, [&](size_t t) {
+            size_t* offset = counts_data + t * num_buckets;
+            for (size_t i = part_begin(t), stop = part_begin(t + 1); i < stop; ++i) {
+                ::new (static_cast<void*>(buf + offset[ids_data[i]]++)) T(std::move(begin[i]));
+            }
+        });
+
+        // sort the buckets taken one by one, and move them back
+        std::atomic<size_t> next(0);
+        mtl::parallel_run(threads, [&](size_t) {
+            for (size_t b = next++; b < num_buckets; b = next++) {
+                size_t first = bucket_starts[b];
+                size_t last = bucket_starts[b + 1];
+                if (b % 2 == 0) {
+                    mtl::pdqsort(buf + first, buf + last);
+                }
+                for (size_t i = first; i < last; ++i) {
+                    begin[i] = std::move(buf[i]);
+                    buf[i].~T();
+                }
+            }
+        });
+    }
+}
+
+#endif
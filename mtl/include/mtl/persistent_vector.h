@@ -0,0 +1,974 @@
+#ifndef MTL_PERSISTENT_VECTOR_H
+#define MTL_PERSISTENT_VECTOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace mtl {
+    typedef std::size_t size_t;
+
+    template <typename T, typename Allocator>
+    class transient_vector;
+
+    /* The immutable vector, every modification returns a new version and leaves this one unchanged.
+       It's a relaxed radix balanced tree (RRB tree): the elements are in leaves of 32, and the inner nodes have
+       up to 32 children. A node whose children (except the last) are all full is indexed by the bits of the index,
+       the other ones keep the cumulative sizes of their children to be searched. The versions share the nodes they
+       have in common, which are reference counted, so copying a version is O(1) and push_back, set, slice and
+       concat copy only O(log32 n) nodes.
+       concat joins the two trees along their seam without redistributing the leaves, only the two leaves meeting
+       at the seam are merged if they fit in one.
+       Use transient() for a batch of modifications, it modifies the nodes it owns alone in place.
+       All the versions sharing nodes should have equal allocators. */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class persistent_vector : private Allocator {
+        friend class transient_vector<T, Allocator>;
+
+    private:
+        static constexpr unsigned bits = 5;
+        static constexpr size_t width = size_t(1) << bits;
+
+        struct node {
+            std::atomic<size_t> refs;
+            size_t count;   // the number of elements in a leaf or the number of children of an inner node
+
+            node() : refs(1), count(0) {}
+        };
+
+        struct leaf_node : node {
+            alignas(T) unsigned char storage[width * sizeof(T)];
+
+            T* elems() {
+                return reinterpret_cast<T*>(storage);
+            }
+
+            const T* elems() const {
+                return reinterpret_cast<const T*>(storage);
+            }
+        };
+
+        struct inner_node : node {
+            node* children[width];
+            size_t sizes[width];   // sizes[i] is the number of elements in children [0, i]
+            bool relaxed;          // whether the children must be found by sizes instead of the index bits
+
+            inner_node() : relaxed(false) {}
+        };
+
+        typedef std::allocator_traits<Allocator> alloc_traits;
+        typedef typename alloc_traits::template rebind_alloc<leaf_node> leaf_allocator;
+        typedef typename alloc_traits::template rebind_alloc<inner_node> inner_allocator;
+        typedef std::allocator_traits<leaf_allocator> leaf_traits;
+        typedef std::allocator_traits<inner_allocator> inner_traits;
+
+        // the nodes at level shift are leaves if shift is 0, otherwise their children are at level shift - bits
+        node* root_;
+        size_t size_;
+        unsigned shift_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
+
+        leaf_node* new_leaf();
+        inner_node* new_inner();
+
+        static void retain(node* n) noexcept {
+            n->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // drop a reference to the node at level shift, it's destroyed with its subtree by the last owner
+        void release(node* n, unsigned shift) noexcept;
+
+        static size_t subtree_size(const node* n, unsigned shift) noexcept {
+            return shift == 0 ? n->count : static_cast<const inner_node*>(n)->sizes[n->count - 1];
+        }
+
+        // the child of the inner node at level shift containing the element index
+        static size_t child_index(const inner_node* n, size_t index, unsigned shift) noexcept;
+
+        // recompute the sizes of the inner node at level shift and whether it's relaxed
+        static void refresh(inner_node* n, unsigned shift) noexcept;
+
+        // whether one more element can be appended under the node at level shift
+        static bool has_room(const node* n, unsigned shift) noexcept;
+
+        // make n owned by this vector only, it's replaced by a copy if it's shared
+        void make_unique(node*& n, unsigned shift);
+
+        // create a path of nodes down to a leaf holding one element constructed with args
+        template <typename... Args>
+        node* new_path(unsigned shift, Args&&... args);
+
+        // append an element under n, which should have room
+        template <typename... Args>
+        void push_into(node*& n, unsigned shift, Args&&... args);
+
+        // keep the first count elements under n
+        void take(node*& n, unsigned shift, size_t count);
+
+        // remove the first count elements under n, it should keep at least one
+        void drop(node*& n, unsigned shift, size_t count);
+
+        // remove the inner roots with only one child
+        void collapse() noexcept;
+
+        /* join the right spine of left and the left spine of right
+           return a node at level max(lshift, rshift) + bits holding one or two children */
+        inner_node* merge(node* left, unsigned lshift, node* right, unsigned rshift);
+
+        /* pack the children of left but its last one, the ones of mid and the ones of right but its first one
+           into nodes at level shift, and return a node at level shift + bits holding them. mid is released */
+        inner_node* rebalance(inner_node* left, inner_node* mid, inner_node* right, unsigned shift);
+
+        // return the leaf holding the element index, leaf_begin is set to the index of its first element
+        const leaf_node* leaf_for(size_t index, size_t& leaf_begin) const noexcept;
+
+        // the modifications in place, they copy only the shared nodes on their way
+        template <typename... Args>
+        void push_back_in_place(Args&&... args);
+        void set_in_place(size_t index, T&& elem);
+        void slice_in_place(size_t begin, size_t stop);
+
+    public:
+        /* the iterator caches the leaf it's in, so walking through the vector visits each leaf once
+           it can't modify the elements */
+        class const_iterator {
+        private:
+            const persistent_vector<T, Allocator>* vec_;
+            size_t index_;
+            mutable const T* leaf_;
+            mutable size_t leaf_begin_;
+            mutable size_t leaf_end_;
+
+        public:
+            typedef std::random_access_iterator_tag iterator_category;
+            typedef T value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const T* pointer;
+            typedef const T& reference;
+
+            const_iterator() : vec_(nullptr), index_(0), leaf_(nullptr), leaf_begin_(0), leaf_end_(0) {}
+
+            const_iterator(const persistent_vector<T, Allocator>* vec, size_t index) :
+                vec_(vec), index_(index), leaf_(nullptr), leaf_begin_(0), leaf_end_(0) {}
+
+            const T& operator*() const {
+                if (index_ < leaf_begin_ || index_ >= leaf_end_) {
+                    const leaf_node* leaf = vec_->leaf_for(index_, leaf_begin_);
+                    leaf_ = leaf->elems();
+                    leaf_end_ = leaf_begin_ + leaf->count;
+                }
+                return leaf_[index_ - leaf_begin_];
+            }
+
+            const T* operator->() const {
+                return &operator*();
+            }
+
+            const T& operator[](difference_type n) const {
+                return *(*this + n);
+            }
+
+            bool operator==(const const_iterator& ci) const {
+                return index_ == ci.index_;
+            }
+
+            bool operator!=(const const_iterator& ci) const {
+                return index_ != ci.index_;
+            }
+
+            bool operator<(const const_iterator& ci) const {
+                return index_ < ci.index_;
+            }
+
+            bool operator>(const const_iterator& ci) const {
+                return index_ > ci.index_;
+            }
+
+            bool operator<=(const const_iterator& ci) const {
+                return index_ <= ci.index_;
+            }
+
+            bool operator>=(const const_iterator& ci) const {
+                return index_ >= ci.index_;
+            }
+
+            const_iterator& operator++() {
+                ++index_;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                auto old = *this;
+                ++index_;
+                return old;
+            }
+
+            const_iterator& operator--() {
+                --index_;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                auto old = *this;
+                --index_;
+                return old;
+            }
+
+            const_iterator& operator+=(difference_type n) {
+                index_ += n;
+                return *this;
+            }
+
+            const_iterator& operator-=(difference_type n) {
+                index_ -= n;
+                return *this;
+            }
+
+            const_iterator operator+(difference_type n) const {
+                auto new_itr = *this;
+                return new_itr += n;
+            }
+
+            const_iterator operator-(difference_type n) const {
+                auto new_itr = *this;
+                return new_itr -= n;
+            }
+
+            friend const_iterator operator+(difference_type n, const const_iterator& ci) {
+                return ci + n;
+            }
+
+            difference_type operator-(const const_iterator& ci) const {
+                return static_cast<std::ptrdiff_t>(index_) - static_cast<std::ptrdiff_t>(ci.index_);
+            }
+        };
+
+        typedef const_iterator iterator;
+
+        persistent_vector();
+        explicit persistent_vector(const Allocator& alloc);
+        persistent_vector(std::initializer_list<T> il, const Allocator& alloc = Allocator());
+
+        // share all the nodes of vec in O(1)
+        persistent_vector(const persistent_vector<T, Allocator>& vec);
+        persistent_vector(persistent_vector<T, Allocator>&& vec) noexcept;
+
+        ~persistent_vector();
+
+        persistent_vector<T, Allocator>& operator=(const persistent_vector<T, Allocator>& vec);
+        persistent_vector<T, Allocator>& operator=(persistent_vector<T, Allocator>&& vec) noexcept;
+
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        // it don't check the boundary
+        const T& operator[](size_t index) const {
+            size_t leaf_begin;
+            return leaf_for(index, leaf_begin)->elems()[index - leaf_begin];
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        const T& at(size_t index) const;
+
+        const T& front() const {
+            return at(0);
+        }
+
+        const T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return (*this)[size_ - 1];
+        }
+
+        // return a new version with elem appended
+        persistent_vector<T, Allocator> push_back(const T& elem) const;
+        persistent_vector<T, Allocator> push_back(T&& elem) const;
+
+        // return a new version without the last element
+        persistent_vector<T, Allocator> pop_back() const;
+
+        // return a new version whose element at index is elem, it throw an out_of_range exception if index is invalid
+        persistent_vector<T, Allocator> set(size_t index, const T& elem) const;
+
+        // return the elements of this version followed by the ones of vec
+        persistent_vector<T, Allocator> concat(const persistent_vector<T, Allocator>& vec) const;
+
+        // return the elements [begin, stop), it throw an out_of_range exception if the range is invalid
+        persistent_vector<T, Allocator> slice(size_t begin, size_t stop) const;
+
+        // start a batch of modifications from this version
+        transient_vector<T, Allocator> transient() const {
+            return transient_vector<T, Allocator>(*this);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator begin() const {
+            return cbegin();
+        }
+
+        const_iterator end() const {
+            return cend();
+        }
+    };
+
+    /* The mutable companion of persistent_vector for a batch of modifications, e.g. loading a sequence.
+       The nodes owned by the transient only are modified in place, the ones shared with a version are copied
+       once and then owned by it. persistent() returns the current elements as a version in O(1), and the transient
+       can go on after that, the nodes shared with the returned version are copied when they are modified. */
+    template <typename T, typename Allocator = std::allocator<T>>
+    class transient_vector {
+    private:
+        persistent_vector<T, Allocator> vec_;
+
+    public:
+        transient_vector() = default;
+
+        explicit transient_vector(const Allocator& alloc) : vec_(alloc) {}
+
+        explicit transient_vector(const persistent_vector<T, Allocator>& vec) : vec_(vec) {}
+
+        [[nodiscard]] bool empty() const {
+            return vec_.empty();
+        }
+
+        [[nodiscard]] size_t size() const {
+            return vec_.size();
+        }
+
+        const T& operator[](size_t index) const {
+            return vec_[index];
+        }
+
+        const T& at(size_t index) const {
+            return vec_.at(index);
+        }
+
+        void push_back(const T& elem) {
+            vec_.push_back_in_place(elem);
+        }
+
+        void push_back(T&& elem) {
+            vec_.push_back_in_place(std::move(elem));
+        }
+
+        template <typename... Args>
+        void emplace_back(Args&&... args) {
+            vec_.push_back_in_place(std::forward<Args>(args)...);
+        }
+
+        void pop_back() {
+            if (vec_.empty()) {
+                throw std::out_of_range("There's no element to be popped out.");
+            }
+            vec_.slice_in_place(0, vec_.size() - 1);
+        }
+
+        // replace the element at index, it throw an out_of_range exception if index is invalid
+        void set(size_t index, const T& elem) {
+            if (index >= vec_.size()) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            // copy first in case elem refers to a node which is about to be copied and released
+            vec_.set_in_place(index, T(elem));
+        }
+
+        // return the current elements as a version
+        persistent_vector<T, Allocator> persistent() const {
+            return vec_;
+        }
+    };
+
+    template <typename T, typename Allocator>
+    typename persistent_vector<T, Allocator>::leaf_node* persistent_vector<T, Allocator>::new_leaf() {
+        leaf_allocator la(alloc());
+        leaf_node* leaf = leaf_traits::allocate(la, 1);
+        leaf_traits::construct(la, leaf);
+        return leaf;
+    }
+
+    template <typename T, typename Allocator>
+    typename persistent_vector<T, Allocator>::inner_node* persistent_vector<T, Allocator>::new_inner() {
+        inner_allocator ia(alloc());
+        inner_node* inner = inner_traits::allocate(ia, 1);
+        inner_traits::construct(ia, inner);
+        return inner;
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::release(node* n, unsigned shift) noexcept {
+        if (n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        if (shift == 0) {
+            auto* leaf = static_cast<leaf_node*>(n);
+            for (size_t i = 0; i < leaf->count; ++i) {
+                alloc_traits::destroy(alloc(), leaf->elems() + i);
+            }
+            leaf_allocator la(alloc());
+            leaf_traits::destroy(la, leaf);
+            leaf_traits::deallocate(la, leaf, 1);
+        } else {
+            auto* inner = static_cast<inner_node*>(n);
+            for (size_t i = 0; i < inner->count; ++i) {
+                release(inner->children[i], shift - bits);
+            }
+            inner_allocator ia(alloc());
+            inner_traits::destroy(ia, inner);
+            inner_traits::deallocate(ia, inner, 1);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    size_t persistent_vector<T, Allocator>::child_index(const inner_node* n, size_t index, unsigned shift) noexcept {
+        // a child holds at most 1 << shift elements, so the index bits give the first candidate
+        size_t c = index >> shift;
+        if (n->relaxed) {
+            while (n->sizes[c] <= index) {
+                ++c;
+            }
+        }
+        return c;
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::refresh(inner_node* n, unsigned shift) noexcept {
+        size_t total = 0;
+        n->relaxed = false;
+        for (size_t i = 0; i < n->count; ++i) {
+            size_t s = subtree_size(n->children[i], shift - bits);
+            if (i + 1 < n->count && s != (size_t(1) << shift)) {
+                n->relaxed = true;
+            }
+            total += s;
+            n->sizes[i] = total;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    bool persistent_vector<T, Allocator>::has_room(const node* n, unsigned shift) noexcept {
+        for (; shift > 0; shift -= bits) {
+            if (n->count < width) {
+                return true;
+            }
+            n = static_cast<const inner_node*>(n)->children[n->count - 1];
+        }
+        return n->count < width;
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::make_unique(node*& n, unsigned shift) {
+        if (n->refs.load(std::memory_order_acquire) == 1) {
+            return;
+        }
+
+        if (shift == 0) {
+            auto* src = static_cast<leaf_node*>(n);
+            leaf_node* copy = new_leaf();
+            try {
+                for (; copy->count < src->count; ++copy->count) {
+                    alloc_traits::construct(alloc(), copy->elems() + copy->count, src->elems()[copy->count]);
+                }
+            } catch (...) {
+                release(copy, 0);
+                throw;
+            }
+            release(n, 0);
+            n = copy;
+            return;
+        }
+
+        auto* src = static_cast<inner_node*>(n);
+        inner_node* copy = new_inner();
+        for (size_t i = 0; i < src->count; ++i) {
+            copy->children[i] = src->children[i];
+            copy->sizes[i] = src->sizes[i];
+            retain(src->children[i]);
+        }
+        copy->count = src->count;
+        copy->relaxed = src->relaxed;
+        release(n, shift);
+        n = copy;
+    }
+
+    template <typename T, typename Allocator> template <typename... Args>
+    typename persistent_vector<T, Allocator>::node* persistent_vector<T, Allocator>::new_path(unsigned shift, Args&&... args) {
+        leaf_node* leaf = new_leaf();
+        try {
+            alloc_traits::construct(alloc(), leaf->elems(), std::forward<Args>(args)...);
+        } catch (...) {
+            release(leaf, 0);
+            throw;
+        }
+        leaf->count = 1;
+
+        node* n = leaf;
+        for (unsigned s = bits; s <= shift; s += bits) {
+            inner_node* inner;
+            try {
+                inner = new_inner();
+            } catch (...) {
+                release(n, s - bits);
+                throw;
+            }
+            inner->children[0] = n;
+            inner->sizes[0] = 1;
+            inner->count = 1;
+            n = inner;
+        }
+        return n;
+    }
+
+    template <typename T, typename Allocator> template <typename... Args>
+    void persistent_vector<T, Allocator>::push_into(node*& n, unsigned shift, Args&&... args) {
+        make_unique(n, shift);
+        if (shift == 0) {
+            auto* leaf = static_cast<leaf_node*>(n);
+            alloc_traits::construct(alloc(), leaf->elems() + leaf->count, std::forward<Args>(args)...);
+            ++leaf->count;
+            return;
+        }
+
+        auto* inner = static_cast<inner_node*>(n);
+        node*& last = inner->children[inner->count - 1];
+        if (has_room(last, shift - bits)) {
+            push_into(last, shift - bits, std::forward<Args>(args)...);
+        } else {
+            // the node can't be indexed by the bits any more if its last child isn't completely full
+            bool relaxed = inner->relaxed || subtree_size(last, shift - bits) != (size_t(1) << shift);
+            inner->children[inner->count] = new_path(shift - bits, std::forward<Args>(args)...);
+            inner->sizes[inner->count] = inner->sizes[inner->count - 1];
+            inner->relaxed = relaxed;
+            ++inner->count;
+        }
+        ++inner->sizes[inner->count - 1];
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::take(node*& n, unsigned shift, size_t count) {
+        make_unique(n, shift);
+        if (shift == 0) {
+            auto* leaf = static_cast<leaf_node*>(n);
+            for (size_t i = count; i < leaf->count; ++i) {
+                alloc_traits::destroy(alloc(), leaf->elems() + i);
+            }
+            leaf->count = count;
+            return;
+        }
+
+        auto* inner = static_cast<inner_node*>(n);
+        size_t c = child_index(inner, count - 1, shift);
+        for (size_t i = c + 1; i < inner->count; ++i) {
+            release(inner->children[i], shift - bits);
+        }
+        inner->count = c + 1;
+        take(inner->children[c], shift - bits, count - (c ? inner->sizes[c - 1] : 0));
+        inner->sizes[c] = count;
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::drop(node*& n, unsigned shift, size_t count) {
+        make_unique(n, shift);
+        if (shift == 0) {
+            auto* leaf = static_cast<leaf_node*>(n);
+            T* elems = leaf->elems();
+            for (size_t i = 0; i < count; ++i) {
+                alloc_traits::destroy(alloc(), elems + i);
+            }
+            for (size_t i = count; i < leaf->count; ++i) {
+                alloc_traits::construct(alloc(), elems + i - count, std::move(elems[i]));
+                alloc_traits::destroy(alloc(), elems + i);
+            }
+            leaf->count -= count;
+            return;
+        }
+
+        auto* inner = static_cast<inner_node*>(n);
+        size_t c = child_index(inner, count, shift);
+        size_t before = c ? inner->sizes[c - 1] : 0;
+        for (size_t i = 0; i < c; ++i) {
+            release(inner->children[i], shift - bits);
+        }
+        for (size_t i = c; i < inner->count; ++i) {
+            inner->children[i - c] = inner->children[i];
+        }
+        inner->count -= c;
+        if (count > before) {
+            drop(inner->children[0], shift - bits, count - before);
+        }
+        refresh(inner, shift);
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::collapse() noexcept {
+        while (shift_ > 0 && root_->count == 1) {
+            node* child = static_cast<inner_node*>(root_)->children[0];
+            retain(child);
+            release(root_, shift_);
+            root_ = child;
+            shift_ -= bits;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    typename persistent_vector<T, Allocator>::inner_node* persistent_vector<T, Allocator>::merge(
+        node* left, unsigned lshift, node* right, unsigned rshift) {
+        if (lshift > rshift) {
+            auto* l = static_cast<inner_node*>(left);
+            inner_node* mid = merge(l->children[l->count - 1], lshift - bits, right, rshift);
+            return rebalance(l, mid, nullptr, lshift);
+        }
+        if (lshift < rshift) {
+            auto* r = static_cast<inner_node*>(right);
+            inner_node* mid = merge(left, lshift, r->children[0], rshift - bits);
+            return rebalance(nullptr, mid, r, rshift);
+        }
+
+        if (lshift == 0) {
+            auto* l = static_cast<leaf_node*>(left);
+            auto* r = static_cast<leaf_node*>(right);
+            inner_node* top = new_inner();
+            if (l->count + r->count > width) {
+                retain(l);
+                retain(r);
+                top->children[0] = l;
+                top->children[1] = r;
+                top->count = 2;
+                refresh(top, bits);
+                return top;
+            }
+
+            // the two leaves fit in one
+            leaf_node* leaf;
+            try {
+                leaf = new_leaf();
+            } catch (...) {
+                release(top, bits);
+                throw;
+            }
+            top->children[0] = leaf;
+            top->count = 1;
+            try {
+                for (size_t i = 0; i < l->count; ++i, ++leaf->count) {
+                    alloc_traits::construct(alloc(), leaf->elems() + leaf->count, l->elems()[i]);
+                }
+                for (size_t i = 0; i < r->count; ++i, ++leaf->count) {
+                    alloc_traits::construct(alloc(), leaf->elems() + leaf->count, r->elems()[i]);
+                }
+            } catch (...) {
+                release(top, bits);
+                throw;
+            }
+            refresh(top, bits);
+            return top;
+        }
+
+        auto* l = static_cast<inner_node*>(left);
+        auto* r = static_cast<inner_node*>(right);
+        inner_node* mid = merge(l->children[l->count - 1], lshift - bits, r->children[0], rshift - bits);
+        return rebalance(l, mid, r, lshift);
+    }
+
+    template <typename T, typename Allocator>
+    typename persistent_vector<T, Allocator>::inner_node* persistent_vector<T, Allocator>::rebalance(
+        inner_node* left, inner_node* mid, inner_node* right, unsigned shift) {
+        // at most 31 + 2 + 31 children
+        node* all[3 * width];
+        size_t n = 0;
+        if (left) {
+            for (size_t i = 0; i + 1 < left->count; ++i) {
+                all[n++] = left->children[i];
+            }
+        }
+        for (size_t i = 0; i < mid->count; ++i) {
+            all[n++] = mid->children[i];
+        }
+        if (right) {
+            for (size_t i = 1; i < right->count; ++i) {
+                all[n++] = right->children[i];
+            }
+        }
+
+        inner_node* top;
+        try {
+            top = new_inner();
+        } catch (...) {
+            release(mid, shift);
+            throw;
+        }
+        try {
+            for (size_t begin = 0; begin < n; begin += width) {
+                size_t stop = begin + width < n ? begin + width : n;
+                inner_node* part = new_inner();
+                for (size_t i = begin; i < stop; ++i) {
+                    part->children[i - begin] = all[i];
+                    retain(all[i]);
+                }
+                part->count = stop - begin;
+                refresh(part, shift);
+                top->children[top->count++] = part;
+            }
+        } catch (...) {
+            release(top, shift + bits);
+            release(mid, shift);
+            throw;
+        }
+        refresh(top, shift + bits);
+        release(mid, shift);
+        return top;
+    }
+
+    template <typename T, typename Allocator>
+    const typename persistent_vector<T, Allocator>::leaf_node* persistent_vector<T, Allocator>::leaf_for(
+        size_t index, size_t& leaf_begin) const noexcept {
+        const node* n = root_;
+        leaf_begin = 0;
+        for (unsigned shift = shift_; shift > 0; shift -= bits) {
+            auto* inner = static_cast<const inner_node*>(n);
+            size_t c = child_index(inner, index, shift);
+            if (c) {
+                index -= inner->sizes[c - 1];
+                leaf_begin += inner->sizes[c - 1];
+            }
+            n = inner->children[c];
+        }
+        return static_cast<const leaf_node*>(n);
+    }
+
+    template <typename T, typename Allocator> template <typename... Args>
+    void persistent_vector<T, Allocator>::push_back_in_place(Args&&... args) {
+        if (!root_) {
+            root_ = new_path(0, std::forward<Args>(args)...);
+            shift_ = 0;
+            size_ = 1;
+            return;
+        }
+
+        // the tree is full, add a level above the root
+        if (!has_room(root_, shift_)) {
+            inner_node* inner = new_inner();
+            inner->children[0] = root_;
+            inner->sizes[0] = size_;
+            inner->count = 1;
+            root_ = inner;
+            shift_ += bits;
+        }
+        push_into(root_, shift_, std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::set_in_place(size_t index, T&& elem) {
+        node** n = &root_;
+        make_unique(*n, shift_);
+        for (unsigned shift = shift_; shift > 0; shift -= bits) {
+            auto* inner = static_cast<inner_node*>(*n);
+            size_t c = child_index(inner, index, shift);
+            if (c) {
+                index -= inner->sizes[c - 1];
+            }
+            n = &inner->children[c];
+            make_unique(*n, shift - bits);
+        }
+        static_cast<leaf_node*>(*n)->elems()[index] = std::move(elem);
+    }
+
+    template <typename T, typename Allocator>
+    void persistent_vector<T, Allocator>::slice_in_place(size_t begin, size_t stop) {
+        if (begin == stop) {
+            if (root_) {
+                release(root_, shift_);
+            }
+            root_ = nullptr;
+            size_ = 0;
+            shift_ = 0;
+            return;
+        }
+        if (stop < size_) {
+            take(root_, shift_, stop);
+            size_ = stop;
+            collapse();
+        }
+        if (begin > 0) {
+            drop(root_, shift_, begin);
+            size_ = stop - begin;
+            collapse();
+        }
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::persistent_vector() : root_(nullptr), size_(0), shift_(0) {}
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::persistent_vector(const Allocator& alloc) :
+        Allocator(alloc), root_(nullptr), size_(0), shift_(0) {}
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::persistent_vector(std::initializer_list<T> il, const Allocator& alloc) :
+        Allocator(alloc), root_(nullptr), size_(0), shift_(0) {
+        try {
+            for (auto itr = il.begin(); itr != il.end(); ++itr) {
+                push_back_in_place(*itr);
+            }
+        } catch (...) {
+            slice_in_place(0, 0);
+            throw;
+        }
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::persistent_vector(const persistent_vector<T, Allocator>& vec) :
+        Allocator(vec.alloc()), root_(vec.root_), size_(vec.size_), shift_(vec.shift_) {
+        if (root_) {
+            retain(root_);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::persistent_vector(persistent_vector<T, Allocator>&& vec) noexcept :
+        Allocator(vec.alloc()), root_(vec.root_), size_(vec.size_), shift_(vec.shift_) {
+        vec.root_ = nullptr;
+        vec.size_ = 0;
+        vec.shift_ = 0;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>::~persistent_vector() {
+        if (root_) {
+            release(root_, shift_);
+        }
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>& persistent_vector<T, Allocator>::operator=(const persistent_vector<T, Allocator>& vec) {
+        if (this == &vec) {
+            return *this;
+        }
+        if (vec.root_) {
+            retain(vec.root_);
+        }
+        if (root_) {
+            release(root_, shift_);
+        }
+        alloc() = vec.alloc();
+        root_ = vec.root_;
+        size_ = vec.size_;
+        shift_ = vec.shift_;
+        return *this;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator>& persistent_vector<T, Allocator>::operator=(persistent_vector<T, Allocator>&& vec) noexcept {
+        if (this == &vec) {
+            return *this;
+        }
+        if (root_) {
+            release(root_, shift_);
+        }
+        alloc() = vec.alloc();
+        root_ = vec.root_;
+        size_ = vec.size_;
+        shift_ = vec.shift_;
+        vec.root_ = nullptr;
+        vec.size_ = 0;
+        vec.shift_ = 0;
+        return *this;
+    }
+
+    template <typename T, typename Allocator>
+    const T& persistent_vector<T, Allocator>::at(size_t index) const {
+        if (index < size_) {
+            return (*this)[index];
+        } else {
+            throw std::out_of_range("The index is out of range.");
+        }
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::push_back(const T& elem) const {
+        persistent_vector<T, Allocator> vec(*this);
+        vec.push_back_in_place(elem);
+        return vec;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::push_back(T&& elem) const {
+        persistent_vector<T, Allocator> vec(*this);
+        vec.push_back_in_place(std::move(elem));
+        return vec;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::pop_back() const {
+        if (empty()) {
+            throw std::out_of_range("There's no element to be popped out.");
+        }
+        return slice(0, size_ - 1);
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::set(size_t index, const T& elem) const {
+        if (index >= size_) {
+            throw std::out_of_range("The index is out of range.");
+        }
+        persistent_vector<T, Allocator> vec(*this);
+        vec.set_in_place(index, T(elem));
+        return vec;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::concat(const persistent_vector<T, Allocator>& vec) const {
+        if (vec.empty()) {
+            return *this;
+        }
+        if (empty()) {
+            return vec;
+        }
+
+        persistent_vector<T, Allocator> result(alloc());
+        result.root_ = result.merge(root_, shift_, vec.root_, vec.shift_);
+        result.shift_ = (shift_ > vec.shift_ ? shift_ : vec.shift_) + bits;
+        result.size_ = size_ + vec.size_;
+        result.collapse();
+        return result;
+    }
+
+    template <typename T, typename Allocator>
+    persistent_vector<T, Allocator> persistent_vector<T, Allocator>::slice(size_t begin, size_t stop) const {
+        if (begin > stop || stop > size_) {
+            throw std::out_of_range("The range is out of the vector.");
+        }
+        persistent_vector<T, Allocator> vec(*this);
+        vec.slice_in_place(begin, stop);
+        return vec;
+    }
+}
+
+#endif
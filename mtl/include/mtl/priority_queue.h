@@ -1,148 +1,148 @@
 #ifndef MTL_PRIORITY_QUEUE_H
 #define MTL_PRIORITY_QUEUE_H
 
-#include <mtl/basic_vector.h>
+#include <stdexcept>
+#include <mtl/vector.h>
 
 namespace mtl {
-    /* The priority queue ADT, implemented by basic_vector so that it could dynamicly expand its capacity. */
-    template <typename T>
-    class priority_queue : public basic_vector<T> {
+    /* The priority queue ADT, a binary min-heap stored in a Container (a vector by default) so that it could dynamicly expand its capacity.
+       The root is at index 0 and the children of the node at index i are at 2i + 1 and 2i + 2.
+       Container should provide push_back, pop_back, clear, size, empty and operator[]. */
+    template <typename T, typename Container = vector<T>>
+    class priority_queue {
     private:
-        /* the number of elements, note that the first element is at index 1 */
-        size_t size_;
+        Container data_;
 
         // check whether the queue is empty, if true, throw a out_of_range exception
-        void check_empty() {
-            if (size_ == o) {
+        void check_empty() const {
+            if (data_.empty()) {
                 throw std::out_of_range("There's no element.");
             }
         }
 
-        // check whether an expansion is needed.
-        void check_expand() {
-            if (size_ + 1 >= basic_vector<T>::capacity()) {
-                basic_vector<T>::expand(2 * basic_vector<T>::capacity());
-            }
-        }
-
         // to percolate up from the last element, to ensure the heap order after push
-        void percolate_up();
-        // to percolate down from position 1, to ensure the heap order after pop
-        void percolate_down();
+        void percolate_up() noexcept;
+        // to percolate down from position pos, to ensure the heap order after pop
+        void percolate_down(size_t pos = 0) noexcept;
+
+        // to build the heap order for all the elements from the bottom up
+        void heapify() noexcept;
 
     public:
-        priority_queue();
-        priority_queue(size_t n);
-        priority_queue(const priority_queue<T>& rhs);
-        priority_queue(priority_queue<T>&& rhs) noexcept;
+        priority_queue() = default;
+        explicit priority_queue(const Container& c);
+        explicit priority_queue(Container&& c);
+        explicit priority_queue(size_t n);
+        priority_queue(const priority_queue<T, Container>& rhs) = default;
+        priority_queue(priority_queue<T, Container>&& rhs) = default;
         virtual ~priority_queue() = default;
 
         // clear the queue
         virtual void clear() {
-            size_ = 0;
-            basic_vector<T>::clear();
+            data_.clear();
         }
 
         size_t size() const {
-            return size_;
+            return data_.size();
         }
 
         bool empty() const {
-            return size_ == 0;
+            return data_.empty();
         }
 
-        priority_queue<T>& operator=(const priority_queue<T>& rhs) {
-            size_ = rhs.size_;
-            basic_vector<T>::operator=(rhs);
-        }
-
-        priority_queue<T>& operator=(priority_queue<T>&& rhs) noexcept {
-            size_ = rhs.size_;
-            basic_vector<T>::operator=(std::move(rhs));
-        }
+        priority_queue<T, Container>& operator=(const priority_queue<T, Container>& rhs) = default;
+        priority_queue<T, Container>& operator=(priority_queue<T, Container>&& rhs) = default;
 
         // push a new element
         void push(const T& elem) {
-            check_expand();
-            ++size_;
-            basic_vector<T>::data()[size_] = elem;
+            data_.push_back(elem);
             percolate_up();
         }
 
         // push a new element
-        void push(T&& elem) noexcept {
-            check_expand();
-            ++size_;
-            basic_vector<T>::data()[size_] = std::move(elem);
+        void push(T&& elem) {
+            data_.push_back(std::move(elem));
             percolate_up();
         }
 
-        // pop the minimum element
-        void pop() noexcept {
+        // pop the minimum element and destroy it
+        void pop() {
             check_empty();
+            // move the last element to the root, then restore the heap order
+            if (data_.size() > 1) {
+                data_[0] = std::move(data_[data_.size() - 1]);
+            }
+            data_.pop_back();
             percolate_down();
         }
 
         // return the minimum element
         const T& top() const {
             check_empty();
-            return basic_vector<T>::data()[1];
+            return data_[0];
         }
 
         T& top() {
-            return const_cast<T&>(static_cast<const priority_queue<T>*>(this)->top());
+            return const_cast<T&>(static_cast<const priority_queue<T, Container>*>(this)->top());
         }
     };
 
-    template <typename T>
-    priority_queue<T>::priority_queue() : size_(0) {}
-
-    template <typename T>
-    priority_queue<T>::priority_queue(size_t size) : size_(0), basic_vector<T>(size) {}
+    template <typename T, typename Container>
+    priority_queue<T, Container>::priority_queue(const Container& c) : data_(c) {
+        heapify();
+    }
 
-    template <typename T>
-    priority_queue<T>::priority_queue(const priority_queue<T>& rhs) :
-        size_(rhs.size_), basic_vector<T>(rhs) {}
+    template <typename T, typename Container>
+    priority_queue<T, Container>::priority_queue(Container&& c) : data_(std::move(c)) {
+        heapify();
+    }
 
-    template <typename T>
-    priority_queue<T>::priority_queue(priority_queue<T>&& rhs) noexcept :
-        size_(rhs.size_), basic_vector<T>(std::move(rhs)) {}
+    template <typename T, typename Container>
+    priority_queue<T, Container>::priority_queue(size_t size) : data_(size) {}
 
-    template <typename T>
-    void priority_queue<T>::percolate_up() noexcept {
-        size_t pos = size_;
-        auto data = basic_vector<T>::data();
-        T temp = std::move(data[pos]);
+    template <typename T, typename Container>
+    void priority_queue<T, Container>::percolate_up() noexcept {
+        size_t pos = data_.size() - 1;
+        T temp = std::move(data_[pos]);
 
-        while (temp < data[pos >> 1]) { // pos >> 1 is equivalent to pos / 2.
+        while (pos > 0 && temp < data_[(pos - 1) >> 1]) { // (pos - 1) >> 1 is the parent
             // move the parent down
-            data[pos] = std::move(data[pos >> 1]);
-            pos >>= 1;
+            data_[pos] = std::move(data_[(pos - 1) >> 1]);
+            pos = (pos - 1) >> 1;
         }
-        data[pos] = std::move(temp);
+        data_[pos] = std::move(temp);
     }
 
-    template <typename T>
-    void priority_queue<T>::percolate_down() noexcept {
-        auto data = basic_vector<T>::data();
-        T temp = std::move(data[size_]); 
-        --size_;
-        size_t pos = 1;
-        while ((pos << 1) <= size_) { // pos << 1 is equivalent to pos * 2
-            size_t child = pos << 1;
+    template <typename T, typename Container>
+    void priority_queue<T, Container>::percolate_down(size_t pos) noexcept {
+        size_t size = data_.size();
+        if (pos >= size) {
+            return;
+        }
+        T temp = std::move(data_[pos]);
+        while ((pos << 1) + 1 < size) { // (pos << 1) + 1 is the left child
+            size_t child = (pos << 1) + 1;
             // choose the smaller child
-            if (child + 1 <= size_) {
-                child = data[child] > data[child + 1] ? child + 1 : child;
+            if (child + 1 < size) {
+                child = data_[child] > data_[child + 1] ? child + 1 : child;
             }
             // move the child up
-            if (data[child] < temp) {
-                data[pos] = std::move(data[child]);
+            if (data_[child] < temp) {
+                data_[pos] = std::move(data_[child]);
                 pos = child;
             } else {
                 break;
             }
         }
-        data[pos] = std::move(temp);
+        data_[pos] = std::move(temp);
+    }
+
+    template <typename T, typename Container>
+    void priority_queue<T, Container>::heapify() noexcept {
+        // the nodes after size / 2 are leaves
+        for (size_t i = data_.size() / 2; i > 0; --i) {
+            percolate_down(i - 1);
+        }
     }
 }
 #endif
\ No newline at end of file
@@ -5,77 +5,72 @@
 #include <mtl/list.h>
 
 namespace mtl {
-    template <typename T>
+    /* The queue ADT, the elements are kept in a Container, which is a linked list by default.
+       The allocator of the queue is chosen by the container, e.g. queue<T, list<T, Allocator>>. */
+    template <typename T, typename Container = list<T>>
     class queue {
         private:
-        list<T>* data_;
+        Container data_;
 
         public:
         queue();
         explicit queue(size_t s);
         explicit queue(std::initializer_list<T>&& il) noexcept;
-        queue(const queue<T>& rhs);
-        queue(queue<T>&& rhs) noexcept;
-        ~queue();
+        queue(const queue<T, Container>& rhs);
+        queue(queue<T, Container>&& rhs) noexcept;
+        ~queue() = default;
 
         size_t size() const {
-            return data_->size();
+            return data_.size();
         }
 
         bool empty() const {
-            return data_->empty();
+            return data_.empty();
         }
 
         void push(const T& elem) {
-            data_->push_back(elem);
+            data_.push_back(elem);
         }
 
         void push(T&& elem) noexcept {
-            data_->push_back(std::move(elem));
+            data_.push_back(std::move(elem));
         }
 
         void pop() {
-            data_->pop_front();
+            data_.pop_front();
         }
 
         const T& front() const {
-            return data_->front();
+            return data_.front();
         }
 
         const T& back() const {
-            return data_->back();
+            return data_.back();
         }
 
         T& front() {
-            return data_->front();
+            return data_.front();
         }
 
         T& back() {
-            return data_->back();
+            return data_.back();
         }
     };
 
-    template <typename T>
-    queue<T>::queue() : data_(new list<T>()) {}
+    template <typename T, typename Container>
+    queue<T, Container>::queue() : data_() {}
 
-    template <typename T>
-    queue<T>::queue(size_t s) : data_(new list<T>(s)) {}
+    template <typename T, typename Container>
+    queue<T, Container>::queue(size_t s) : data_(s) {}
 
-    template <typename T>
-    queue<T>::queue(std::initializer_list<T>&& il) noexcept : data_(new list<T>(std::move(il))) {}
+    template <typename T, typename Container>
+    queue<T, Container>::queue(std::initializer_list<T>&& il) noexcept : data_(std::move(il)) {}
 
-    template <typename T>
-    queue<T>::queue(const queue& rhs) : data_(new list<T>(*rhs.data_)) {}
+    template <typename T, typename Container>
+    queue<T, Container>::queue(const queue& rhs) : data_(rhs.data_) {}
 
-    template <typename T>
-    queue<T>::queue(queue<T>&& rhs) noexcept : data_(rhs.data_) {
-        rhs.data_ = nullptr;
-    }
-
-    template <typename T>
-    queue<T>::~queue() {
-        delete data_;
-    }   
+    template <typename T, typename Container>
+    queue<T, Container>::queue(queue<T, Container>&& rhs) noexcept : data_(std::move(rhs.data_)) {}
 }
 
 #endif
\ No newline at end of file
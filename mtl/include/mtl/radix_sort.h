@@ -0,0 +1,342 @@
+#ifndef MTL_RADIX_SORT_H
+#define MTL_RADIX_SORT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <mtl/vector.h>
+
+namespace mtl {
+    /* How a key is split into the bytes radix sort works on. A specialization provides
+       - bytes: the number of bytes of a key
+       - byte(key, i): the i-th byte, 0 is the least significant one,
+       so that comparing the bytes from the most significant one gives the order of the keys.
+       It's provided for the integers, the IEEE floats, std::pair and std::array of them,
+       specialize it for the other fixed-width keys, e.g. a struct of an id and a timestamp. */
+    template <typename Key, typename = void>
+    struct radix_key;
+
+    // the unsigned integers are their own bytes, the sign bit of the signed ones is flipped to put them after
+    // the negative ones
+    template <typename Key>
+    struct radix_key<Key, std::enable_if_t<std::is_integral<Key>::value>> {
+        typedef std::make_unsigned_t<Key> bits_type;
+
+        static constexpr size_t bytes = sizeof(Key);
+
+        static bits_type bits(Key key) noexcept {
+            auto u = static_cast<bits_type>(key);
+            if constexpr (std::is_signed<Key>::value) {
+                u ^= bits_type(1) << (8 * sizeof(Key) - 1);
+            }
+            return u;
+        }
+
+        static unsigned byte(Key key, size_t i) noexcept {
+            return static_cast<unsigned>(bits(key) >> (8 * i)) & 0xFF;
+        }
+    };
+
+    // the positive floats are flipped the sign bit, and the negative ones all the bits to reverse their order,
+    // so -0.0 comes before 0.0 and the NaNs go to the ends by their sign
+    template <typename Key>
+    struct radix_key<Key, std::enable_if_t<std::is_floating_point<Key>::value>> {
+        static_assert(sizeof(Key) == 4 || sizeof(Key) == 8, "radix_key supports the IEEE float and double");
+
+        typedef std::conditional_t<sizeof(Key) == 4, std::uint32_t, std::uint64_t> bits_type;
+
+        static constexpr size_t bytes = sizeof(Key);
+
+        static bits_type bits(Key key) noexcept {
+            bits_type u;
+            std::memcpy(&u, &key, sizeof(Key));
+            constexpr bits_type sign = bits_type(1) << (8 * sizeof(Key) - 1);
+            return u & sign ? ~u : u | sign;
+        }
+
+        static unsigned byte(Key key, size_t i) noexcept {
+            return static_cast<unsigned>(bits(key) >> (8 * i)) & 0xFF;
+        }
+    };
+
+    // first is more significant than second
+    template <typename First, typename Second>
+    struct radix_key<std::pair<First, Second>> {
+        static constexpr size_t bytes = radix_key<First>::bytes + radix_key<Second>::bytes;
+
+        static unsigned byte(const std::pair<First, Second>& key, size_t i) noexcept {
+            if (i < radix_key<Second>::bytes) {
+                return radix_key<Second>::byte(key.second, i);
+            }
+            return radix_key<First>::byte(key.first, i - radix_key<Second>::bytes);
+        }
+    };
+
+    // the elements are compared in order, the first one is the most significant
+    template <typename Elem, size_t N>
+    struct radix_key<std::array<Elem, N>> {
+        static constexpr size_t bytes = radix_key<Elem>::bytes * N;
+
+        static unsigned byte(const std::array<Elem, N>& key, size_t i) noexcept {
+            return radix_key<Elem>::byte(key[N - 1 - i / radix_key<Elem>::bytes], i % radix_key<Elem>::bytes);
+        }
+    };
+
+    // the ranges shorter than it are sorted by insertion sort, both by radix_sort and the buckets of MSD
+    inline constexpr size_t radix_insertion_threshold = 64;
+
+    // the keys longer than it (in bytes) are sorted by MSD, the others by LSD
+    inline constexpr size_t radix_lsd_max_bytes = 8;
+
+    struct radix_identity {
+        template <typename T>
+        const T& operator()(const T& value) const noexcept {
+            return value;
+        }
+    };
+
+    /* sort the random access range [begin, end) by the keys key_fn(elem) in ascending order, it's stable.
+       the keys are split into bytes by radix_key, e.g. the unsigned and signed integers, the floats and doubles,
+       std::pair and std::array of them.
+       the keys up to 8 bytes are sorted by LSD: the histograms of all the bytes are counted in one pass,
+       then each byte which isn't the same for all the keys is sorted by counting, moving the elements between
+       the range and a scratch buffer by turns. The longer keys are sorted by MSD from the most significant byte,
+       and the buckets shorter than radix_insertion_threshold are left to insertion sort.
+       key_fn is called a few times for each element and should be cheap, it shouldn't throw */
+    template <typename Iterator, typename KeyFn>
+    void radix_sort(Iterator begin, Iterator end, KeyFn key_fn);
+
+    // sort the elements themselves as the keys
+    template <typename Iterator>
+    void radix_sort(Iterator begin, Iterator end) {
+        mtl::radix_sort(begin, end, radix_identity());
+    }
+
+    // whether radix_key<Key> provides bits(key), the key as an unsigned integer
+    template <typename Key, typename = void>
+    struct has_radix_bits : std::false_type {};
+
+    template <typename Key>
+    struct has_radix_bits<Key, std::void_t<decltype(radix_key<Key>::bits(std::declval<const Key&>()))>> :
+        std::true_type {};
+
+    // the key up to 8 bytes as an unsigned integer of the same order
+    template <typename Key>
+    auto radix_bits(const Key& key) noexcept {
+        if constexpr (has_radix_bits<Key>::value) {
+            return radix_key<Key>::bits(key);
+        } else {
+            static_assert(radix_key<Key>::bytes <= 8, "the key is too long to be an integer");
+            std::uint64_t bits = 0;
+            for (size_t i = radix_key<Key>::bytes; i-- > 0;) {
+                bits = bits << 8 | radix_key<Key>::byte(key, i);
+            }
+            return bits;
+        }
+    }
+
+    // whether key a is less than key b, comparing the bytes from the byte at index from to the least significant
+    template <typename Key>
+    bool radix_less(const Key& a, const Key& b, size_t from) {
+        if constexpr (radix_key<Key>::bytes <= radix_lsd_max_bytes) {
+            // the short keys are compared at once
+            (void) from;
+            return mtl::radix_bits(a) < mtl::radix_bits(b);
+        } else {
+            for (size_t i = from + 1; i-- > 0;) {
+                unsigned x = radix_key<Key>::byte(a, i);
+                unsigned y = radix_key<Key>::byte(b, i);
+                if (x != y) {
+                    return x < y;
+                }
+            }
+            return false;
+        }
+    }
+
+    // stable insertion sort [begin, begin + n) by the bytes of the keys from the byte at index from
+    template <typename Iterator, typename KeyFn>
+    void radix_insertion_sort(Iterator begin, size_t n, KeyFn& key_fn, size_t from) {
+        for (size_t i = 1; i < n; ++i) {
+            if (!mtl::radix_less(key_fn(begin[i]), key_fn(begin[i - 1]), from)) {
+                continue;
+            }
+            auto elem = std::move(begin[i]);
+            size_t hole = i;
+            do {
+                begin[hole] = std::move(begin[hole - 1]);
+                --hole;
+            } while (hole > 0 && mtl::radix_less(key_fn(elem), key_fn(begin[hole - 1]), from));
+            begin[hole] = std::move(elem);
+        }
+    }
+
+    // move the n elements from src to dst in the order of their d-th bytes, offsets are where the buckets start
+    template <typename Key, typename Src, typename Dst, typename KeyFn>
+    void radix_scatter(Src src, Dst dst, size_t n, KeyFn& key_fn, size_t d, size_t* offsets) {
+        for (size_t i = 0; i < n; ++i) {
+            unsigned b = radix_key<Key>::byte(key_fn(src[i]), d);
+            dst[offsets[b]++] = std::move(src[i]);
+        }
+    }
+
+    // whether the elements are moved into the scratch buffer when it's made, instead of leaving it uninitialized
+    template <typename T>
+    inline constexpr bool radix_buffer_moves_v =
+        !(std::is_trivially_copyable<T>::value && std::is_default_constructible<T>::value);
+
+    // the scratch buffer of n elements, see radix_buffer_moves_v
+    template <typename T, typename Iterator>
+    vector<T> radix_buffer(Iterator begin, size_t n) {
+        vector<T> buffer;
+        if constexpr (radix_buffer_moves_v<T>) {
+            buffer.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                buffer.push_back(std::move(begin[i]));
+            }
+        } else {
+            buffer.resize(n, default_init);
+        }
+        return buffer;
+    }
+
+    /* MSD sort [begin, begin + n) by the bytes from the byte at index d, buf is the part of the scratch buffer
+       of the same length */
+    template <typename Key, typename Iterator, typename Buffer, typename KeyFn>
+    void radix_sort_msd(Iterator begin, Buffer buf, size_t n, KeyFn& key_fn, size_t d) {
+        while (true) {
+            if (n < radix_insertion_threshold) {
+                mtl::radix_insertion_sort(begin, n, key_fn, d);
+                return;
+            }
+
+            size_t counts[256] = {};
+            for (size_t i = 0; i < n; ++i) {
+                ++counts[radix_key<Key>::byte(key_fn(begin[i]), d)];
+            }
+
+            // all the keys have the same byte, go on to the next one without moving them
+            bool same = false;
+            for (size_t c : counts) {
+                if (c == n) {
+                    same = true;
+                    break;
+                }
+            }
+            if (!same) {
+                size_t offsets[256];
+                size_t sum = 0;
+                for (size_t b = 0; b < 256; ++b) {
+                    offsets[b] = sum;
+                    sum += counts[b];
+                }
+                mtl::radix_scatter<Key>(begin, buf, n, key_fn, d, offsets);
+                for (size_t i = 0; i < n; ++i) {
+                    begin[i] = std::move(buf[i]);
+                }
+            }
+            if (d == 0) {
+                return;
+            }
+            if (same) {
+                --d;
+                continue;
+            }
+
+            size_t start = 0;
+            for (size_t b = 0; b < 256; ++b) {
+                if (counts[b] > 1) {
+                    mtl::radix_sort_msd<Key>(begin + start, buf + start, counts[b], key_fn, d - 1);
+                }
+                start += counts[b];
+            }
+            return;
+        }
+    }
+
+    template <typename Iterator, typename KeyFn>
+    void radix_sort(Iterator begin, Iterator end, KeyFn key_fn) {
+        static_assert(is_random_access_iterator_v<Iterator>, "radix_sort needs the random access iterators");
+
+        typedef typename std::iterator_traits<Iterator>::value_type T;
+        typedef std::decay_t<decltype(key_fn(*begin))> Key;
+        constexpr size_t key_bytes = radix_key<Key>::bytes;
+
+        size_t n = static_cast<size_t>(end - begin);
+        if (n < radix_insertion_threshold) {
+            mtl::radix_insertion_sort(begin, n, key_fn, key_bytes - 1);
+            return;
+        }
+
+        if constexpr (key_bytes > radix_lsd_max_bytes) {
+            auto buffer = mtl::radix_buffer<T>(begin, n);
+            if constexpr (radix_buffer_moves_v<T>) {
+                // the elements are in the buffer, sort them there and take the range as the scratch
+                mtl::radix_sort_msd<Key>(buffer.begin(), begin, n, key_fn, key_bytes - 1);
+                for (size_t i = 0; i < n; ++i) {
+                    begin[i] = std::move(buffer[i]);
+                }
+            } else {
+                mtl::radix_sort_msd<Key>(begin, buffer.begin(), n, key_fn, key_bytes - 1);
+            }
+        } else {
+            // the histograms of all the bytes in one pass
+            size_t counts[key_bytes][256] = {};
+            for (size_t i = 0; i < n; ++i) {
+                auto bits = mtl::radix_bits(key_fn(begin[i]));
+                for (size_t d = 0; d < key_bytes; ++d) {
+                    ++counts[d][static_cast<unsigned>(bits >> (8 * d)) & 0xFF];
+                }
+            }
+
+            // the bytes which are the same for all the keys don't change the order
+            size_t passes[key_bytes];
+            size_t num_passes = 0;
+            for (size_t d = 0; d < key_bytes; ++d) {
+                bool same = false;
+                for (size_t c : counts[d]) {
+                    if (c == n) {
+                        same = true;
+                        break;
+                    }
+                }
+                if (!same) {
+                    passes[num_passes++] = d;
+                }
+            }
+            if (num_passes == 0) {
+                return;
+            }
+
+            // the elements go to the buffer and back by turns
+            auto buffer = mtl::radix_buffer<T>(begin, n);
+            bool in_buffer = radix_buffer_moves_v<T>;
+            for (size_t p = 0; p < num_passes; ++p) {
+                size_t d = passes[p];
+                size_t offsets[256];
+                size_t sum = 0;
+                for (size_t b = 0; b < 256; ++b) {
+                    offsets[b] = sum;
+                    sum += counts[d][b];
+                }
+                if (in_buffer) {
+                    mtl::radix_scatter<Key>(buffer.begin(), begin, n, key_fn, d, offsets);
+                } else {
+                    mtl::radix_scatter<Key>(begin, buffer.begin(), n, key_fn, d, offsets);
+                }
+                in_buffer = !in_buffer;
+            }
+            if (in_buffer) {
+                for (size_t i = 0; i < n; ++i) {
+                    begin[i] = std::move(buffer[i]);
+                }
+            }
+        }
+    }
+}
+
+#endif
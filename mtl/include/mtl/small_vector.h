@@ -0,0 +1,153 @@
+#ifndef MTL_SMALL_VECTOR_H
+#define MTL_SMALL_VECTOR_H
+
+#include <initializer_list>
+#include <mtl/vector.h>
+
+namespace mtl {
+    /* The vector which keeps up to N elements in a local array inside the object, so the short sequences never
+       touch the allocator. When the N cells run out, the elements spill to an array from Allocator which grows by
+       Growth like a vector, and they move back to the local array if it's shrunk to at most N elements.
+       It provides all the operations and iterators of vector. */
+    template <typename T, size_t N, typename Allocator = std::allocator<T>, typename Growth = double_growth>
+    class small_vector : public vector<T, Allocator, Growth> {
+        static_assert(N > 0, "the local array of small_vector can't be empty");
+
+    private:
+        // the local array, the elements in it are managed by basic_vector
+        alignas(T) unsigned char buffer_[N * sizeof(T)];
+
+        /* destroy the elements and let basic_vector hold nothing, which its destructor can't do as it doesn't see
+           the local array. It's called by the destructor, and by a constructor which throws since the destructor
+           doesn't run then */
+        void abandon() noexcept {
+            basic_vector<T, Allocator, Growth>::release();
+            basic_vector<T, Allocator, Growth>::adopt_local_buffer(nullptr, 0);
+        }
+
+    protected:
+        T* local_buffer() noexcept override {
+            return reinterpret_cast<T*>(buffer_);
+        }
+
+        size_t local_capacity() const noexcept override {
+            return N;
+        }
+
+    public:
+        small_vector();
+        explicit small_vector(const Allocator& alloc);
+
+        // construct an empty small_vector with particular capacity, it's allocated only if s > N
+        explicit small_vector(size_t s, const Allocator& alloc = Allocator());
+
+        // construct from initializer list, the size will be the same with the il.
+        small_vector(std::initializer_list<T>&& il, const Allocator& alloc = Allocator());
+
+        small_vector(const small_vector<T, N, Allocator, Growth>& rhs);
+
+        // the elements are moved one by one into the local array if rhs keeps them in its local array
+        small_vector(small_vector<T, N, Allocator, Growth>&& rhs)
+            noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_constructible);
+
+        ~small_vector() override;
+
+        small_vector<T, N, Allocator, Growth>& operator=(const small_vector<T, N, Allocator, Growth>& rhs);
+        small_vector<T, N, Allocator, Growth>& operator=(small_vector<T, N, Allocator, Growth>&& rhs)
+            noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_assignable);
+
+        // return whether the elements are kept in the local array
+        bool is_inline() const {
+            return basic_vector<T, Allocator, Growth>::data() == reinterpret_cast<const T*>(buffer_);
+        }
+    };
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector() {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector(const Allocator& alloc) : vector<T, Allocator, Growth>(alloc) {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector(size_t s, const Allocator& alloc) :
+        vector<T, Allocator, Growth>(alloc) {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+        try {
+            basic_vector<T, Allocator, Growth>::expand(s);
+        } catch (...) {
+            abandon();
+            throw;
+        }
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector(std::initializer_list<T>&& il, const Allocator& alloc) :
+        vector<T, Allocator, Growth>(alloc) {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+        try {
+            basic_vector<T, Allocator, Growth>::expand(il.size());
+            for (auto itr = il.begin(); itr != il.end(); ++itr) {
+                this->push_back(*itr);
+            }
+        } catch (...) {
+            abandon();
+            throw;
+        }
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector(const small_vector<T, N, Allocator, Growth>& rhs) :
+        vector<T, Allocator, Growth>(std::allocator_traits<Allocator>::select_on_container_copy_construction(
+            rhs.get_allocator())) {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+        try {
+            basic_vector<T, Allocator, Growth>::operator=(rhs);
+        } catch (...) {
+            abandon();
+            throw;
+        }
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::small_vector(small_vector<T, N, Allocator, Growth>&& rhs)
+        noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_constructible) :
+        vector<T, Allocator, Growth>(rhs.get_allocator()) {
+        basic_vector<T, Allocator, Growth>::adopt_local_buffer(local_buffer(), N);
+        // the allocators are equal, only the moves of the elements may throw
+        if constexpr (basic_vector<T, Allocator, Growth>::nothrow_move_constructible) {
+            basic_vector<T, Allocator, Growth>::operator=(std::move(rhs));
+        } else {
+            try {
+                basic_vector<T, Allocator, Growth>::operator=(std::move(rhs));
+            } catch (...) {
+                abandon();
+                throw;
+            }
+        }
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>::~small_vector() {
+        abandon();
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>& small_vector<T, N, Allocator, Growth>::operator=(
+        const small_vector<T, N, Allocator, Growth>& rhs) {
+        basic_vector<T, Allocator, Growth>::operator=(rhs);
+        return *this;
+    }
+
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    small_vector<T, N, Allocator, Growth>& small_vector<T, N, Allocator, Growth>::operator=(
+        small_vector<T, N, Allocator, Growth>&& rhs) noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_assignable) {
+        basic_vector<T, Allocator, Growth>::operator=(std::move(rhs));
+        return *this;
+    }
+}
+
+#endif
@@ -0,0 +1,279 @@
+#ifndef MTL_SOA_VECTOR_H
+#define MTL_SOA_VECTOR_H
+
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <mtl/index_iterator.h>
+#include <mtl/vector.h>
+#include <mtl/vector_view.h>
+
+namespace mtl {
+    /* The row of a soa_vector, a tuple of references to the fields of one record. Assigning to a row writes
+       the fields of its record, a row converts to the record (the fields are moved out of an rvalue row),
+       and swapping two rows swaps their records. So the algorithms moving the elements through the iterators,
+       e.g. std::sort and std::reverse, work on the rows as on the records. */
+    template <typename... Ts>
+    class soa_row : public std::tuple<Ts&...> {
+    public:
+        typedef std::tuple<std::remove_const_t<Ts>...> value_type;
+
+    private:
+        typedef std::index_sequence_for<Ts...> fields;
+
+        template <typename Tuple, size_t... Is>
+        void assign(const Tuple& rhs, std::index_sequence<Is...>) {
+            ((std::get<Is>(*this) = std::get<Is>(rhs)), ...);
+        }
+
+        template <typename Tuple, size_t... Is>
+        void assign_moved(Tuple& rhs, std::index_sequence<Is...>) {
+            ((std::get<Is>(*this) = std::move(std::get<Is>(rhs))), ...);
+        }
+
+        template <size_t... Is>
+        value_type moved(std::index_sequence<Is...>) const {
+            return value_type(std::move(std::get<Is>(*this))...);
+        }
+
+        template <size_t... Is>
+        void swap_fields(const soa_row& rhs, std::index_sequence<Is...>) const {
+            using std::swap;
+            (swap(std::get<Is>(*this), std::get<Is>(rhs)), ...);
+        }
+
+    public:
+        explicit soa_row(Ts&... fields) : std::tuple<Ts&...>(fields...) {}
+
+        soa_row(const soa_row&) = default;
+
+        // the assignments write through the references, they never rebind them
+        soa_row& operator=(const soa_row& rhs) {
+            assign(rhs, fields());
+            return *this;
+        }
+
+        soa_row& operator=(soa_row&& rhs) {
+            assign_moved(rhs, fields());
+            return *this;
+        }
+
+        soa_row& operator=(const value_type& record) {
+            assign(record, fields());
+            return *this;
+        }
+
+        soa_row& operator=(value_type&& record) {
+            assign_moved(record, fields());
+            return *this;
+        }
+
+        operator value_type() const& {
+            return value_type(static_cast<const std::tuple<Ts&...>&>(*this));
+        }
+
+        operator value_type() && {
+            return moved(fields());
+        }
+
+        // the rows are the prvalues returned by the iterators, so they are swapped by value
+        friend void swap(soa_row lhs, soa_row rhs) {
+            lhs.swap_fields(rhs, fields());
+        }
+    };
+
+    /* The vector of records stored as a struct of arrays: field I of every record lives in its own vector, the
+       column I. A loop reading one field only touches that column, so no cache line is wasted on the other fields
+       and column<I>() gives a contiguous span which the compiler can vectorize.
+       A record is read and written through a row, a tuple of references to its fields, and the iterators go
+       through the rows. The columns always have the same size. */
+    template <typename... Ts>
+    class soa_vector {
+        static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+
+    public:
+        typedef std::tuple<Ts...> value_type;
+        typedef soa_row<Ts...> reference;
+        typedef soa_row<const Ts...> const_reference;
+
+        typedef index_iterator<soa_vector<Ts...>, value_type, reference> iterator;
+        typedef index_iterator<const soa_vector<Ts...>, const value_type, const_reference> const_iterator;
+
+        template <size_t I>
+        using column_type = std::tuple_element_t<I, value_type>;
+
+    private:
+        typedef std::index_sequence_for<Ts...> columns;
+
+        std::tuple<vector<Ts>...> columns_;
+
+        template <size_t... Is>
+        reference row(size_t index, std::index_sequence<Is...>) {
+            return reference(std::get<Is>(columns_)[index]...);
+        }
+
+        template <size_t... Is>
+        const_reference row(size_t index, std::index_sequence<Is...>) const {
+            return const_reference(std::get<Is>(columns_)[index]...);
+        }
+
+        /* append one field to every column, if a column throws the fields already appended are popped,
+           so the columns keep the same size */
+        template <size_t... Is, typename... Args>
+        void append(std::index_sequence<Is...>, Args&&... fields);
+
+        // move the elements of every column to the order of perm, row i gets the old row perm[i]
+        template <size_t... Is>
+        void permute(const vector<size_t>& perm, std::index_sequence<Is...>);
+
+    public:
+        soa_vector() = default;
+
+        [[nodiscard]] bool empty() const {
+            return size() == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return std::get<0>(columns_).size();
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return std::get<0>(columns_).capacity();
+        }
+
+        // reserve the space for n records in every column
+        void reserve(size_t n) {
+            std::apply([n](auto&... column) { (column.reserve(n), ...); }, columns_);
+        }
+
+        void clear() noexcept {
+            std::apply([](auto&... column) { (column.clear(), ...); }, columns_);
+        }
+
+        // the contiguous elements of column I
+        template <size_t I>
+        vector_view<column_type<I>> column() {
+            return std::get<I>(columns_).view();
+        }
+
+        template <size_t I>
+        vector_view<const column_type<I>> column() const {
+            return std::get<I>(columns_).view();
+        }
+
+        // the row at index, it don't check the boundary
+        reference operator[](size_t index) {
+            return row(index, columns());
+        }
+
+        const_reference operator[](size_t index) const {
+            return row(index, columns());
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        reference at(size_t index) {
+            if (index >= size()) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return row(index, columns());
+        }
+
+        const_reference at(size_t index) const {
+            if (index >= size()) {
+                throw std::out_of_range("The index is out of range.");
+            }
+            return row(index, columns());
+        }
+
+        void push_back(const value_type& record) {
+            std::apply([this](const Ts&... fields) { append(columns(), fields...); }, record);
+        }
+
+        void push_back(value_type&& record) {
+            std::apply([this](Ts&&... fields) { append(columns(), std::move(fields)...); }, std::move(record));
+        }
+
+        // append a record whose field I is constructed from fields[I]
+        template <typename... Args>
+        reference emplace_back(Args&&... fields) {
+            static_assert(sizeof...(Args) == sizeof...(Ts), "emplace_back needs one argument for each column");
+            append(columns(), std::forward<Args>(fields)...);
+            return row(size() - 1, columns());
+        }
+
+        void pop_back() {
+            if (empty()) {
+                throw std::out_of_range("There's no element to be popped out.");
+            }
+            std::apply([](auto&... column) { (column.pop_back(), ...); }, columns_);
+        }
+
+        /* sort the records by column I with comp, the other columns are permuted along with it
+           the order is computed on the indices first, then each column is moved once */
+        template <size_t I, typename Compare = std::less<column_type<I>>>
+        void sort_by(Compare comp = Compare());
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, size());
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size());
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <typename... Ts> template <size_t... Is, typename... Args>
+    void soa_vector<Ts...>::append(std::index_sequence<Is...>, Args&&... fields) {
+        size_t appended = 0;
+        try {
+            ((std::get<Is>(columns_).emplace_back(std::forward<Args>(fields)), ++appended), ...);
+        } catch (...) {
+            ((Is < appended ? std::get<Is>(columns_).pop_back() : void()), ...);
+            throw;
+        }
+    }
+
+    template <typename... Ts> template <size_t... Is>
+    void soa_vector<Ts...>::permute(const vector<size_t>& perm, std::index_sequence<Is...>) {
+        auto permute_column = [&perm](auto& column) {
+            std::remove_reference_t<decltype(column)> sorted(perm.size());
+            for (size_t i = 0; i < perm.size(); ++i) {
+                sorted.push_back(std::move(column[perm[i]]));
+            }
+            column = std::move(sorted);
+        };
+        (permute_column(std::get<Is>(columns_)), ...);
+    }
+
+    template <typename... Ts> template <size_t I, typename Compare>
+    void soa_vector<Ts...>::sort_by(Compare comp) {
+        vector<size_t> perm(size());
+        for (size_t i = 0; i < size(); ++i) {
+            perm.push_back(i);
+        }
+        const auto& keys = std::get<I>(columns_);
+        size_t* first = perm.view().data();
+        std::sort(first, first + perm.size(), [&keys, &comp](size_t a, size_t b) { return comp(keys[a], keys[b]); });
+        permute(perm, columns());
+    }
+}
+
+#endif
@@ -0,0 +1,344 @@
+#ifndef MTL_STABLE_VECTOR_H
+#define MTL_STABLE_VECTOR_H
+
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <mtl/index_iterator.h>
+#include <mtl/vector.h>
+
+namespace mtl {
+    /* The vector whose elements never move. They are kept in chunks of ChunkSize elements, and a directory holds
+       the pointers to the chunks. Growing allocates one more chunk and only the directory is reallocated, so
+       push_back takes O(1) without the copying spikes of vector, and the pointers and references to the elements
+       stay valid until they are popped or the vector is cleared.
+       operator[] costs one more indirection than vector. ChunkSize must be a power of 2, so the index is split
+       by a shift and a mask. The chunks are kept after the elements are removed, shrink_to_fit frees them. */
+    template <typename T, size_t ChunkSize = 256, typename Allocator = std::allocator<T>>
+    class stable_vector : private Allocator {
+        static_assert(ChunkSize > 0 && (ChunkSize & (ChunkSize - 1)) == 0, "ChunkSize must be a power of 2");
+
+    public:
+        typedef index_iterator<stable_vector<T, ChunkSize, Allocator>, T> iterator;
+        typedef index_iterator<const stable_vector<T, ChunkSize, Allocator>, const T> const_iterator;
+
+    private:
+        typedef std::allocator_traits<Allocator> alloc_traits;
+        typedef typename alloc_traits::template rebind_alloc<T*> directory_allocator;
+
+        // the pointers to the chunks, all of them are allocated
+        vector<T*, directory_allocator> chunks_;
+        size_t size_;
+
+        Allocator& alloc() noexcept {
+            return *this;
+        }
+
+        const Allocator& alloc() const noexcept {
+            return *this;
+        }
+
+        T* slot(size_t index) const noexcept {
+            return chunks_[index / ChunkSize] + index % ChunkSize;
+        }
+
+        // append one more chunk to the directory
+        void add_chunk();
+
+        // destroy the elements and free the chunks
+        void release() noexcept;
+
+    public:
+        stable_vector();
+        explicit stable_vector(const Allocator& alloc);
+        stable_vector(std::initializer_list<T>&& il, const Allocator& alloc = Allocator());
+        stable_vector(const stable_vector<T, ChunkSize, Allocator>& rhs);
+        stable_vector(stable_vector<T, ChunkSize, Allocator>&& rhs) noexcept;
+
+        ~stable_vector();
+
+        stable_vector<T, ChunkSize, Allocator>& operator=(const stable_vector<T, ChunkSize, Allocator>& rhs);
+        // it allocates new chunks when the allocators differ and don't propagate
+        stable_vector<T, ChunkSize, Allocator>& operator=(stable_vector<T, ChunkSize, Allocator>&& rhs) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value);
+
+        Allocator get_allocator() const {
+            return alloc();
+        }
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        [[nodiscard]] size_t capacity() const {
+            return chunks_.size() * ChunkSize;
+        }
+
+        // allocate the chunks for n elements, the elements don't move either way
+        void reserve(size_t n);
+
+        // free the chunks behind the last element
+        void shrink_to_fit() noexcept;
+
+        // it don't check the boundary
+        const T& operator[](size_t index) const {
+            return *slot(index);
+        }
+
+        T& operator[](size_t index) {
+            return *slot(index);
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        const T& at(size_t index) const;
+
+        T& at(size_t index) {
+            return const_cast<T&>(static_cast<const stable_vector<T, ChunkSize, Allocator>*>(this)->at(index));
+        }
+
+        const T& front() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(0);
+        }
+
+        const T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this vector.");
+            }
+            return *slot(size_ - 1);
+        }
+
+        T& front() {
+            return const_cast<T&>(static_cast<const stable_vector<T, ChunkSize, Allocator>*>(this)->front());
+        }
+
+        T& back() {
+            return const_cast<T&>(static_cast<const stable_vector<T, ChunkSize, Allocator>*>(this)->back());
+        }
+
+        void push_back(const T& elem) {
+            emplace_back(elem);
+        }
+
+        void push_back(T&& elem) {
+            emplace_back(std::move(elem));
+        }
+
+        // construct an element at the end in place with args, return a reference to it
+        template <typename... Args>
+        T& emplace_back(Args&&... args);
+
+        // remove the last element and destroy it
+        void pop_back();
+
+        // destroy all the elements, the chunks are kept
+        void clear() noexcept;
+
+        iterator begin() {
+            return iterator(this, 0);
+        }
+
+        iterator end() {
+            return iterator(this, size_);
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, size_);
+        }
+
+        const_iterator cbegin() const {
+            return begin();
+        }
+
+        const_iterator cend() const {
+            return end();
+        }
+    };
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::add_chunk() {
+        T* chunk = alloc_traits::allocate(alloc(), ChunkSize);
+        try {
+            chunks_.push_back(chunk);
+        } catch (...) {
+            alloc_traits::deallocate(alloc(), chunk, ChunkSize);
+            throw;
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::release() noexcept {
+        clear();
+        for (size_t i = 0; i < chunks_.size(); ++i) {
+            alloc_traits::deallocate(alloc(), chunks_[i], ChunkSize);
+        }
+        chunks_.clear();
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::stable_vector() : chunks_(directory_allocator(alloc())), size_(0) {}
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::stable_vector(const Allocator& alloc) :
+        Allocator(alloc), chunks_(directory_allocator(alloc)), size_(0) {}
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::stable_vector(std::initializer_list<T>&& il, const Allocator& alloc) :
+        Allocator(alloc), chunks_(directory_allocator(alloc)), size_(0) {
+        try {
+            reserve(il.size());
+            for (auto itr = il.begin(); itr != il.end(); ++itr) {
+                emplace_back(*itr);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::stable_vector(const stable_vector<T, ChunkSize, Allocator>& rhs) :
+        Allocator(alloc_traits::select_on_container_copy_construction(rhs.alloc())),
+        chunks_(directory_allocator(alloc())), size_(0) {
+        try {
+            reserve(rhs.size_);
+            for (size_t i = 0; i < rhs.size_; ++i) {
+                emplace_back(rhs[i]);
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::stable_vector(stable_vector<T, ChunkSize, Allocator>&& rhs) noexcept :
+        Allocator(rhs.alloc()), chunks_(std::move(rhs.chunks_)), size_(rhs.size_) {
+        rhs.size_ = 0;
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>::~stable_vector() {
+        release();
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>& stable_vector<T, ChunkSize, Allocator>::operator=(
+        const stable_vector<T, ChunkSize, Allocator>& rhs) {
+        if (this == &rhs) {
+            return *this;
+        }
+        if (alloc_traits::propagate_on_container_copy_assignment::value && alloc() != rhs.alloc()) {
+            // the chunks must be freed by the allocator which created them
+            release();
+        }
+        if (alloc_traits::propagate_on_container_copy_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        clear();
+        reserve(rhs.size_);
+        for (size_t i = 0; i < rhs.size_; ++i) {
+            emplace_back(rhs[i]);
+        }
+        return *this;
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    stable_vector<T, ChunkSize, Allocator>& stable_vector<T, ChunkSize, Allocator>::operator=(
+        stable_vector<T, ChunkSize, Allocator>&& rhs) noexcept(
+        alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) {
+        if (this == &rhs) {
+            return *this;
+        }
+        release();
+        if (alloc_traits::propagate_on_container_move_assignment::value) {
+            alloc() = rhs.alloc();
+        }
+
+        if (alloc_traits::propagate_on_container_move_assignment::value || alloc() == rhs.alloc()) {
+            chunks_ = std::move(rhs.chunks_);
+            size_ = rhs.size_;
+            rhs.size_ = 0;
+        } else {
+            // our allocator can't free the chunks of rhs, move the elements into new chunks,
+            // it's the only case where a move changes their addresses
+            reserve(rhs.size_);
+            for (size_t i = 0; i < rhs.size_; ++i) {
+                emplace_back(std::move(rhs[i]));
+            }
+            rhs.release();
+        }
+        return *this;
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::reserve(size_t n) {
+        size_t chunks = (n + ChunkSize - 1) / ChunkSize;
+        chunks_.reserve(chunks);
+        while (chunks_.size() < chunks) {
+            add_chunk();
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::shrink_to_fit() noexcept {
+        size_t chunks = (size_ + ChunkSize - 1) / ChunkSize;
+        while (chunks_.size() > chunks) {
+            alloc_traits::deallocate(alloc(), chunks_.back(), ChunkSize);
+            chunks_.pop_back();
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    const T& stable_vector<T, ChunkSize, Allocator>::at(size_t index) const {
+        if (index < size_) {
+            return *slot(index);
+        } else {
+            throw std::out_of_range("The index is out of range.");
+        }
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator> template <typename... Args>
+    T& stable_vector<T, ChunkSize, Allocator>::emplace_back(Args&&... args) {
+        if (size_ == capacity()) {
+            add_chunk();
+        }
+        T* p = slot(size_);
+        alloc_traits::construct(alloc(), p, std::forward<Args>(args)...);
+        ++size_;
+        return *p;
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::pop_back() {
+        if (empty()) {
+            throw std::out_of_range("There's no element to be popped out.");
+        }
+        --size_;
+        alloc_traits::destroy(alloc(), slot(size_));
+    }
+
+    template <typename T, size_t ChunkSize, typename Allocator>
+    void stable_vector<T, ChunkSize, Allocator>::clear() noexcept {
+        if constexpr (!std::is_trivially_destructible<T>::value) {
+            for (size_t i = 0; i < size_; ++i) {
+                alloc_traits::destroy(alloc(), slot(i));
+            }
+        }
+        size_ = 0;
+    }
+}
+
+#endif
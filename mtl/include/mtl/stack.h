@@ -2,76 +2,68 @@
 #define MTL_STACK_H
 
 #include <initializer_list>
-#include <mtl/basic_vector.h>
+#include <stdexcept>
+#include <mtl/vector.h>
 
 namespace mtl {
-    template <typename T>
-    class stack : public basic_vector<T> {
+    /* The stack ADT, the elements are kept in a Container whose back is the top of the stack.
+       Container should provide push_back, pop_back, size, empty and operator[],
+       the allocator of the stack is chosen by the container, e.g. stack<T, vector<T, Allocator>>. */
+    template <typename T, typename Container = vector<T>>
+    class stack {
         private:
-        size_t size_;
+        Container data_;
 
         public:
-        stack();
+        stack() = default;
+        explicit stack(const Container& c) : data_(c) {}
+        explicit stack(Container&& c) : data_(std::move(c)) {}
         explicit stack(size_t size_);
-        stack(std::initializer_list<T>&& il) noexcept;
-        stack(const stack<T>& rhs);
-        stack(stack<T>&& rhs) noexcept;
+        stack(std::initializer_list<T>&& il);
+        stack(const stack<T, Container>& rhs) = default;
+        stack(stack<T, Container>&& rhs) = default;
         virtual ~stack() = default;
 
+        stack<T, Container>& operator=(const stack<T, Container>& rhs) = default;
+        stack<T, Container>& operator=(stack<T, Container>&& rhs) = default;
+
         bool empty() const {
-            return size_ == 0;
+            return data_.empty();
         }
 
         size_t size() const {
-            return size_;
+            return data_.size();
         }
 
         void push(const T& elem) {
-            if (size_ >= basic_vector<T>::capacity()) {
-                basic_vector<T>::expand(size_ * 2);
-            }
-            basic_vector<T>::operator[](size_) = elem;
-            ++size_;
+            data_.push_back(elem);
         }
 
-        void push(T&& elem) noexcept {
-            if (size_ >= basic_vector<T>::capacity()) {
-                basic_vector<T>::expand(size_ * 2);
-            }
-            basic_vector<T>::operator[](size_) = std::move(elem);
-            ++size_;
+        void push(T&& elem) {
+            data_.push_back(std::move(elem));
         }
 
+        // remove the top element and destroy it
         void pop() {
-            --size_;
+            data_.pop_back();
         }
 
         const T& top() const {
-            if (size_ == 0)
-                throw std::out_of_range("There's no element to be popped out.");
+            if (empty())
+                throw std::out_of_range("There's no element at the top.");
 
-            return data_[size_ - 1];
+            return data_[size() - 1];
         }
 
         T& top() {
-            return const_cast<T&>(static_cast<const stack<T>*>(this)->top());
+            return const_cast<T&>(static_cast<const stack<T, Container>*>(this)->top());
         }
     };
 
-    template <typename T>
-    stack<T>::stack() : size_(0) {}
-    
-    template <typename T>
-    stack<T>::stack(size_t s) : size_(0), basic_vector<T>(s) {}
-
-    template <typename T>
-    stack<T>::stack(std::initializer_list<T>&& il) noexcept :
-        size_(0), basic_vector<T>(std::move(il)) {}
-
-    template <typename T>
-    stack<T>::stack(const stack<T>& rhs) : size_(rhs.size_), basic_vector<T>(rhs) {}
+    template <typename T, typename Container>
+    stack<T, Container>::stack(size_t s) : data_(s) {}
 
-    template <typename T> stack<T>::stack(stack<T>&& rhs) noexcept :
-        size_(rhs.size()), basic_vector<T>(std::move(rhs)) {}
+    template <typename T, typename Container>
+    stack<T, Container>::stack(std::initializer_list<T>&& il) : data_(std::move(il)) {}
 }
 #endif
\ No newline at end of file
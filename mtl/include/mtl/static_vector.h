@@ -0,0 +1,63 @@
+#ifndef MTL_STATIC_VECTOR_H
+#define MTL_STATIC_VECTOR_H
+
+#include <initializer_list>
+#include <mtl/allocator.h>
+#include <mtl/small_vector.h>
+
+namespace mtl {
+    /* The vector with a fixed capacity N whose elements are always in the local array, it never touches the heap.
+       Any operation which needs more than N cells throws a length_error and leaves the elements unchanged,
+       try_push_back reports it by the return value instead. It provides all the operations and iterators of vector,
+       and it can be the container of stack and priority_queue, e.g. stack<T, static_vector<T, 64>>. */
+    template <typename T, size_t N>
+    class static_vector : public small_vector<T, N, null_allocator<T>> {
+    public:
+        // the capacity, it's a constant expression
+        static constexpr size_t static_capacity = N;
+
+        static_vector() = default;
+
+        // construct an empty static_vector, throw a length_error if s > N
+        explicit static_vector(size_t s) : small_vector<T, N, null_allocator<T>>(s) {}
+
+        // construct from initializer list, throw a length_error if it has more than N elements
+        static_vector(std::initializer_list<T>&& il) : small_vector<T, N, null_allocator<T>>(std::move(il)) {}
+
+        static_vector(const static_vector<T, N>& rhs) = default;
+        static_vector(static_vector<T, N>&& rhs) = default;
+        ~static_vector() override = default;
+
+        static_vector<T, N>& operator=(const static_vector<T, N>& rhs) = default;
+        static_vector<T, N>& operator=(static_vector<T, N>&& rhs) = default;
+
+        static constexpr size_t max_size() noexcept {
+            return N;
+        }
+
+        // return whether no more element can be inserted
+        bool full() const {
+            return this->size() == N;
+        }
+
+        // append an element if there's room, return whether it's appended
+        bool try_push_back(const T& elem) {
+            if (full()) {
+                return false;
+            }
+            this->push_back(elem);
+            return true;
+        }
+
+        // the version using right-value reference
+        bool try_push_back(T&& elem) {
+            if (full()) {
+                return false;
+            }
+            this->push_back(std::move(elem));
+            return true;
+        }
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef MTL_TYPE_TRAITS_H
+#define MTL_TYPE_TRAITS_H
+
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace mtl {
+    /* Whether an object of T can be moved to another address by copying its bytes and then forgetting the source,
+       no move constructor or destructor needs to be called. The containers use it to move elements with memmove.
+       It's true for the trivially copyable types, specialize it for the other types which are safe to relocate,
+       e.g. the types holding only a unique pointer to the heap. */
+    template <typename T>
+    struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+    template <typename T>
+    inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+    /* Whether Allocator provides T* reallocate(T* p, size_t old_n, size_t new_n), which resizes the array p
+       keeping its bytes and may grow it in place. The containers use it for the trivially relocatable elements. */
+    template <typename Allocator, typename = void>
+    struct has_reallocate : std::false_type {};
+
+    template <typename Allocator>
+    struct has_reallocate<Allocator, std::void_t<decltype(std::declval<Allocator&>().reallocate(
+        std::declval<typename Allocator::value_type*>(), std::size_t(), std::size_t()))>> : std::true_type {};
+
+    template <typename Allocator>
+    inline constexpr bool has_reallocate_v = has_reallocate<Allocator>::value;
+
+    /* Whether Iterator is tagged as a random access iterator by std::iterator_traits (the pointers are),
+       so the distance between two of them is got by subtraction in O(1). */
+    template <typename Iterator, typename = void>
+    struct is_random_access_iterator : std::false_type {};
+
+    template <typename Iterator>
+    struct is_random_access_iterator<Iterator, std::void_t<typename std::iterator_traits<Iterator>::iterator_category>> :
+        std::is_base_of<std::random_access_iterator_tag, typename std::iterator_traits<Iterator>::iterator_category> {};
+
+    template <typename Iterator>
+    inline constexpr bool is_random_access_iterator_v = is_random_access_iterator<Iterator>::value;
+
+    // Whether Range provides size(), which is expected to return the number of its elements in O(1)
+    template <typename Range, typename = void>
+    struct has_size : std::false_type {};
+
+    template <typename Range>
+    struct has_size<Range, std::void_t<decltype(std::declval<const Range&>().size())>> : std::true_type {};
+
+    template <typename Range>
+    inline constexpr bool has_size_v = has_size<Range>::value;
+}
+
+#endif
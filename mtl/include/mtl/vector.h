@@ -8,182 +8,75 @@
 #include <mtl/algorithms.h>
 #include <stdexcept>
 #include <initializer_list>
+#include <iterator>
 #include <mtl/basic_vector.h>
+#include <mtl/vector_iterator.h>
 
 // The namespace where the ADTs are.
 namespace mtl {
-    /* The vector ADT, it can expand its data array to double size when space is not enough. */
-    template <typename T>
-    class vector : public basic_vector<T> {
-    private:
-        // the number of elements
-        size_t size_;
-
-        /* the iterator that cannot modify the element it refers but can change which object if refers */
-        class const_iterator {
-        private:
-            const T* elem_;   // pointer to the element
-        public:
-            const_iterator();
-            virtual ~const_iterator() = default;
-
-            // construct from pointer
-            explicit const_iterator(const T* elem);   
-
-            const_iterator(const const_iterator& ci);
-            const_iterator(const_iterator&& ci) noexcept;
-            // return a reference to the element           
-            const T& operator*() const;   
-
-            // compare the pointer
-            bool operator>(const const_iterator& ci) const {
-                return elem_ > ci.elem_;
-            }
-
-            // compare the pointer
-            bool operator<(const const_iterator& ci) const {
-                return elem_ < ci.elem_;
-            }
-
-            // compare the pointer
-            bool operator<=(const const_iterator& ci) const {
-                return elem_ <= ci.elem_;
-            }
-
-            // compare the pointer
-            bool operator>=(const const_iterator& ci) const {
-                return elem_ >= ci.elem_;
-            }
-
-            // compare the pointer
-            bool operator==(const const_iterator& ci) const {
-                return elem_ == ci.elem_;
-            }
-
-            // compare the pointer
-            bool operator!=(const const_iterator& ci) const {
-                return elem_ != ci.elem_;
-            }
-
-            explicit operator bool() const {
-                return elem_;
-            }
-
-            const_iterator& operator=(const const_iterator& ci);
-            const_iterator& operator=(const_iterator&& ci) noexcept;
-
-            // move n items next, it don't check the boundary
-            const_iterator operator+(size_t n);
-            // move n items next, it don't check the boundary
-            const_iterator& operator+=(size_t n);
-            // move n items previous, it don't check the boundary
-            const_iterator operator-(size_t n);
-            // move n items previous, it don't check the boundary
-            const_iterator& operator-=(size_t n);
-
-            // prefix increment
-            const_iterator& operator++();
-            // postfix increment
-            const_iterator operator++(int);
-            // prefix decrement
-            const_iterator& operator--();
-            // postfix decrement
-            const_iterator operator--(int);
-        };
-
-        /* The normal iterator which derived from the const_iterator 
-           Both the value of the element and which element it refers are modifiable */
-        class iterator : public const_iterator {
-        public:
-            iterator() = default;
-            explicit iterator(T* elem);
-            iterator(const iterator& itr);
-            iterator(iterator&& itr) noexcept;
-            ~iterator() override = default;
-
-            T& operator*() {
-                return const_cast<T&>(const_iterator::operator*());
-            }
-
-            iterator& operator+=(size_t n) {
-                const_iterator::operator+=(n);
-                return *this;
-            }
-            iterator operator+(size_t n) {
-                auto new_itr = *this;
-                return new_itr.operator+=(n);
-            }
-            iterator& operator-=(size_t n) {
-                const_iterator::operator-=(n);
-                return *this;
-            }
-            iterator operator-(size_t n) {
-                auto new_itr = *this;
-                return new_itr.operator-=(n);
-            } 
-
-            iterator& operator=(const iterator& itr);
-            iterator& operator=(iterator&& itr) noexcept;
-
-            iterator& operator++();
-            iterator operator++(int);
-            iterator& operator--();
-            iterator operator--(int);
-        };
+    template <typename T, size_t N, typename Allocator, typename Growth>
+    class small_vector;
 
+    /* The vector ADT, it can expand its data array by Growth (double size by default) when space is not enough. */
+    template <typename T, typename Allocator = std::allocator<T>, typename Growth = double_growth>
+    class vector : public basic_vector<T, Allocator, Growth> {
     public:
+        typedef vector_const_iterator<T> const_iterator;
+        typedef vector_iterator<T> iterator;
+
         // the default constructor
         vector();  
 
-        // construct the vector with particular size
-        explicit vector(size_t s);   
+        // construct an empty vector whose memory comes from alloc
+        explicit vector(const Allocator& alloc);
+
+        // construct an empty vector with particular capacity
+        explicit vector(size_t s, const Allocator& alloc = Allocator());   
 
         // construct from initializer list, the size will be the same with the il.
-        vector(std::initializer_list<T>&& elems) noexcept;   
+        vector(std::initializer_list<T>&& elems, const Allocator& alloc = Allocator());   
 
         // copy constructor
-        vector(const vector<T>& vec);  
+        vector(const vector<T, Allocator, Growth>& vec);  
 
         // moving copy constructor
-        vector(vector<T>&& vec) noexcept;  
+        vector(vector<T, Allocator, Growth>&& vec) noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_constructible);
+
+        // the elements in the local array of vec are moved into a new array, so it may throw a bad_alloc
+        template <size_t N>
+        vector(small_vector<T, N, Allocator, Growth>&& vec);
 
         // the destructor
         virtual ~vector() = default;
 
         // return whether the vector is empty
         [[nodiscard]] bool empty() const {
-            return size_ == 0;
+            return basic_vector<T, Allocator, Growth>::empty();
         }
 
         // return the size
         [[nodiscard]] size_t  size() const {
-            return size_;
+            return basic_vector<T, Allocator, Growth>::size();
         }
 
         // return the capacity
         [[nodiscard]] size_t capacity() const {
-            return basic_vector<T>::capacity();
+            return basic_vector<T, Allocator, Growth>::capacity();
         }
 
         virtual void shrink() {
-            basic_vector<T>::shrink(size_);
-        }
-
-        // delete the array and assign nullptr to data_
-        virtual void clear() {
-            basic_vector<T>::clear();
-            size_ = 0;
+            basic_vector<T, Allocator, Growth>::shrink(size());
         }
 
         /* return the reference to the element at position index 
            it don't check the boundary */
         virtual const T& operator[](size_t index) const {
-            return basic_vector<T>::data()[index];
+            return basic_vector<T, Allocator, Growth>::data()[index];
         }
 
         // the const version
         virtual T& operator[](size_t index) {
-            return basic_vector<T>::data()[index];
+            return basic_vector<T, Allocator, Growth>::data()[index];
         }
 
         /* the same with operator[] but check the boundary 
@@ -193,407 +86,366 @@ namespace mtl {
         // the const version
         T& at(size_t index);  
 
-        // return a vector contains the elements [begin, stop)
-        vector<T> splice(size_t begin, size_t stop);
+        // return a vector contains the elements [begin, stop), use view().subview(begin, stop) to avoid the copy
+        vector<T, Allocator, Growth> splice(size_t begin, size_t stop);
 
         const T& front() const {
-            if (size_ == 0) {
+            if (empty()) {
                 throw std::out_of_range("There's no element in this vector.");
             }
-            return basic_vector<T>::data()[0];
+            return basic_vector<T, Allocator, Growth>::data()[0];
         }
 
         const T& back() const {
-            if (size_ == 0) {
+            if (empty()) {
                 throw std::out_of_range("There's no element in this vector.");
             }
-            return basic_vector<T>::data[size_ - 1];
+            return basic_vector<T, Allocator, Growth>::data()[size() - 1];
         }
 
         T& front() {
-            return const_cast<T&>(static_cast<const vector<T>*>(this)->front());
+            return const_cast<T&>(static_cast<const vector<T, Allocator, Growth>*>(this)->front());
         }
 
         T& back() {
-            return const_cast<T&>(static_cast<const vector<T>*>(this)->back());
+            return const_cast<T&>(static_cast<const vector<T, Allocator, Growth>*>(this)->back());
         }
 
         // append an element to the end of the vector
         void push_back(const T& elem);   
 
         // the version using right-value reference
-        void push_back(T&& elem) noexcept;   
+        void push_back(T&& elem);   
 
-        // remove the last element (simply decrease the size_)
+        // construct an element at the end in place with args, return a reference to it
+        template <typename... Args>
+        T& emplace_back(Args&&... args);
+
+        // remove the last element and destroy it
         void pop_back();     
 
         /* insert an element at position index, r
         return an iterator pointing to the next cell */
-        iterator insert(iterator index, const T& elem) noexcept;   
+        iterator insert(iterator index, const T& elem);   
 
         // using the right-value reference
-        iterator insert(iterator index, T&& elem) noexcept;        
+        iterator insert(iterator index, T&& elem);        
+
+        /* construct an element with args before index
+           return an iterator pointing to the next cell */
+        template <typename... Args>
+        iterator emplace(iterator index, Args&&... args);
 
         /* insert another from another container (deep copy) with iterators
            which provide ++, --, ==, and != operators*/
         template <typename InputIterator>
         iterator insert(iterator index, InputIterator begin, InputIterator end);
 
+        /* insert the elements of range (any container or array) before index, they are moved if range is an rvalue
+           the following elements are shifted only once, and the length is got in O(1) if range provides size()
+           or random access iterators. range should not be this vector.
+           return an iterator pointing to the cell after the inserted elements */
+        template <typename Range>
+        iterator insert_range(iterator index, Range&& range);
+
+        // append the elements of range to the end, they are moved if range is an rvalue
+        template <typename Range>
+        void append_range(Range&& range) {
+            insert_range(this->end(), std::forward<Range>(range));
+        }
+
         // remove the elements at position index
         iterator remove(iterator index) noexcept;    
 
         // remove the range [begin, stop)
         iterator remove(iterator begin, iterator stop) noexcept;  
 
+        /* remove the elements satisfying pred in one stable pass, return the number of removed elements
+           unlike calling remove for each of them, every kept element moves at most once */
+        template <typename Predicate>
+        size_t remove_if(Predicate pred) {
+            return basic_vector<T, Allocator, Growth>::compact([&pred](size_t, T& elem) { return bool(pred(elem)); });
+        }
+
+        /* remove the elements at the positions in indices in one stable pass, return the number of removed elements
+           indices must be sorted in ascending order, the duplicates and the positions out of range are ignored */
+        template <typename Range>
+        size_t remove_indices(const Range& indices);
+
         // return whether two vector is equal (whether the data_ is equal)
-        bool operator==(const vector<T>& vec) const {
-            return basic_vector<T>::data() == vec.data();
+        bool operator==(const vector<T, Allocator, Growth>& vec) const {
+            return basic_vector<T, Allocator, Growth>::data() == vec.data();
         }
 
         // the copy assignment operator
-        vector<T>& operator=(const vector<T>& vec);  
+        vector<T, Allocator, Growth>& operator=(const vector<T, Allocator, Growth>& vec);  
 
         // the moving assignment operator
-        vector<T>& operator=(vector<T>&& vec) noexcept;  
+        vector<T, Allocator, Growth>& operator=(vector<T, Allocator, Growth>&& vec)
+            noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_assignable);
+
+        // the same with the constructor taking a small_vector, it may throw a bad_alloc
+        template <size_t N>
+        vector<T, Allocator, Growth>& operator=(small_vector<T, N, Allocator, Growth>&& vec);
 
         // return a const_iterator pointing to the position 0
         const_iterator cbegin() const {
-            return const_iterator(basic_vector<T>::data());
+            return const_iterator(basic_vector<T, Allocator, Growth>::data());
         }
 
         // return a const_iterator pointing to the position after the last element
         const_iterator cend() const {
-            return const_iterator(basic_vector<T>::data() + size_);
+            return const_iterator(basic_vector<T, Allocator, Growth>::data() + size());
         }
 
         // return an iterator pointing to the first element
         iterator begin() {
-            return iterator(basic_vector<T>::data());
+            return iterator(basic_vector<T, Allocator, Growth>::data());
         }
 
         // return an iterator pointing to the element behind the last one
         iterator end() {
-            return iterator(basic_vector<T>::data() + size_);
+            return iterator(basic_vector<T, Allocator, Growth>::data() + size());
         }
 
         // return a const_iterator pointing to the position 0
         const_iterator begin() const {
-            return const_iterator(basic_vector<T>::data());
+            return const_iterator(basic_vector<T, Allocator, Growth>::data());
         }
 
         // return a const_iterator pointing to the position after the last element
         const_iterator end() const {
-            return const_iterator(basic_vector<T>::data() + size_);
+            return const_iterator(basic_vector<T, Allocator, Growth>::data() + size());
         }
     };
 
-    template <typename T>
-    vector<T>::vector() : size_(0) {}
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector() = default;
+
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector(const Allocator& alloc) : basic_vector<T, Allocator, Growth>(alloc) {}
 
-    template <typename T>
-    vector<T>::vector(size_t n) : size_(0), basic_vector<T>(n) {}
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector(size_t n, const Allocator& alloc) : basic_vector<T, Allocator, Growth>(n, alloc) {}
 
-    template <typename T>
-    vector<T>::vector(std::initializer_list<T>&& il) noexcept : size_(il.size()), basic_vector<T>(il.size()) {
-        auto itr = il.begin();
-        auto data_ = basic_vector<T>::data();
-        for (int i = 0; i < size_; ++i) {
-            data_[i] = std::move(*(itr++));
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector(std::initializer_list<T>&& il, const Allocator& alloc) :
+        basic_vector<T, Allocator, Growth>(il.size(), alloc) {
+        for (auto itr = il.begin(); itr != il.end(); ++itr) {
+            basic_vector<T, Allocator, Growth>::construct_back(*itr);
         }
     }
 
-    template <typename T>
-    vector<T>::vector(const vector<T>& rhs) : size_(rhs.size_), basic_vector<T>(rhs) {}
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector(const vector<T, Allocator, Growth>& rhs) : basic_vector<T, Allocator, Growth>(rhs) {}
 
-    template <typename T>
-    vector<T>::vector(vector<T>&& rhs) noexcept : 
-        size_(rhs.size_), basic_vector<T>(std::move(rhs)) {
-        rhs.size_ = 0;
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>::vector(vector<T, Allocator, Growth>&& rhs)
+        noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_constructible) :
+        basic_vector<T, Allocator, Growth>(std::move(rhs)) {}
+
+    template <typename T, typename Allocator, typename Growth> template <size_t N>
+    vector<T, Allocator, Growth>::vector(small_vector<T, N, Allocator, Growth>&& rhs) :
+        basic_vector<T, Allocator, Growth>(rhs.get_allocator()) {
+        basic_vector<T, Allocator, Growth>::move_from(rhs);
     }
 
-    template <typename T>
-    const T& vector<T>::at(size_t index) const {
-        if (index < size_) {
-            return basic_vector<T>::data[index];
+    template <typename T, typename Allocator, typename Growth>
+    const T& vector<T, Allocator, Growth>::at(size_t index) const {
+        if (index < size()) {
+            return basic_vector<T, Allocator, Growth>::data()[index];
         } else {
             throw std::out_of_range("The index is out of range.");
         }
     }
 
-    template <typename T>
-    T& vector<T>::at(size_t index) {
-        return const_cast<T&>(static_cast<const vector<T>*>(this)->at(index));
+    template <typename T, typename Allocator, typename Growth>
+    T& vector<T, Allocator, Growth>::at(size_t index) {
+        return const_cast<T&>(static_cast<const vector<T, Allocator, Growth>*>(this)->at(index));
     }
 
-    template <typename T>
-    vector<T> vector<T>::splice(size_t begin, size_t stop) {
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth> vector<T, Allocator, Growth>::splice(size_t begin, size_t stop) {
         size_t size = stop - begin;
-        vector<T> vec(size);
+        vector<T, Allocator, Growth> vec(size, basic_vector<T, Allocator, Growth>::get_allocator());
         for (size_t i = 0; i < size; ++i) {
-            vec[i] = basic_vector<T>::data[begin + i];
+            vec.push_back(basic_vector<T, Allocator, Growth>::data()[begin + i]);
         }
 
         return vec;
     }
 
-    template <typename T>
-    void vector<T>::push_back(const T& elem) {
-        if (size_ >= basic_vector<T>::capacity()) {
-            basic_vector<T>::expand(size_ * 2);
-        }
-        basic_vector<T>::data()[size_] = elem;
-        ++size_;
+    template <typename T, typename Allocator, typename Growth>
+    void vector<T, Allocator, Growth>::push_back(const T& elem) {
+        basic_vector<T, Allocator, Growth>::construct_back(elem);
     }
 
-    template <typename T>
-    void vector<T>::push_back(T&& elem) noexcept {
-        if (size_ >= basic_vector<T>::capacity()) {
-            basic_vector<T>::expand(size_ * 2);
-        }
-        basic_vector<T>::data()[size_] = std::move(elem);
-        ++size_;
+    template <typename T, typename Allocator, typename Growth>
+    void vector<T, Allocator, Growth>::push_back(T&& elem) {
+        basic_vector<T, Allocator, Growth>::construct_back(std::move(elem));
     }
 
-    template <typename T>
-    void vector<T>::pop_back() {
-        if (size_ == 0) {
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    T& vector<T, Allocator, Growth>::emplace_back(Args&&... args) {
+        return basic_vector<T, Allocator, Growth>::construct_back(std::forward<Args>(args)...);
+    }
+
+    template <typename T, typename Allocator, typename Growth>
+    void vector<T, Allocator, Growth>::pop_back() {
+        if (empty()) {
             throw std::out_of_range("There's no element to be popped out.");
         }
-        --size_;
+        basic_vector<T, Allocator, Growth>::destroy_back();
     }
 
-    template <typename T>
-    typename vector<T>::iterator vector<T>::insert(iterator index, const T& elem) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(iterator index, const T& elem) {
         // check the validity of index
         if (index > this->end()) {
             return iterator();
         }
-        // check the capacity
-        if (size_ >= basic_vector<T>::capacity()) {
-            size_t len = count_length(this->begin(), index);
-            basic_vector<T>::expand(size_ * 2);
-            index = this->begin() + len;
-        }
+        size_t pos = index - this->begin();
 
-        for (iterator i = this->end(), j = i - 1; i > index; --i, --j) {
-            *i = std::move(*j);
-        }
-        *index = elem;
-        ++size_;
-        return ++index;
+        // copy first in case elem refers to an element of this vector
+        T temp(elem);
+        basic_vector<T, Allocator, Growth>::open_gap(pos, 1);
+        basic_vector<T, Allocator, Growth>::construct_at(basic_vector<T, Allocator, Growth>::data() + pos, std::move(temp));
+        return this->begin() + (pos + 1);
     }
 
-    template <typename T>
-    typename vector<T>::iterator vector<T>::insert(iterator index, T&& elem) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(iterator index, T&& elem) {
         if (index > this->end()) {
             return iterator();
         }
-        if (size_ >= basic_vector<T>::capacity()) {
-            size_t len = count_length(this->begin(), index);
-            basic_vector<T>::expand(size_ * 2);
-            index = this->begin() + len;
+        size_t pos = index - this->begin();
+        basic_vector<T, Allocator, Growth>::open_gap(pos, 1);
+        basic_vector<T, Allocator, Growth>::construct_at(basic_vector<T, Allocator, Growth>::data() + pos, std::move(elem));
+        return this->begin() + (pos + 1);
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename... Args>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::emplace(iterator index, Args&&... args) {
+        if (index > this->end()) {
+            return iterator();
         }
-        for (iterator i = this->end(), j = i - 1; i != index; --i, --j) {
-            *i = std::move(*j);
+        size_t pos = index - this->begin();
+
+        // at the end the element is constructed in place
+        if (pos == size()) {
+            basic_vector<T, Allocator, Growth>::construct_back(std::forward<Args>(args)...);
+            return this->end();
         }
-        *index = std::move(elem);
-        ++size_;
-        return ++index; 
+
+        // the arguments may refer to the elements which are about to move
+        T temp(std::forward<Args>(args)...);
+        basic_vector<T, Allocator, Growth>::open_gap(pos, 1);
+        basic_vector<T, Allocator, Growth>::construct_at(basic_vector<T, Allocator, Growth>::data() + pos, std::move(temp));
+        return this->begin() + (pos + 1);
     }
 
-    template <typename T> template <typename InputIterator>
-    typename vector<T>::iterator vector<T>::insert(iterator index, InputIterator begin, InputIterator end) {
+    template <typename T, typename Allocator, typename Growth> template <typename InputIterator>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert(iterator index, InputIterator begin, InputIterator end) {
         // check the validity of index
         if (index > this->end()) {
             return iterator();
         }
 
         size_t len = count_length(begin, end);
+        size_t pos = index - this->begin();
 
-        // check whether the capacity is big enough
-        size_ += len;
-        if (size_ > basic_vector<T>::capacity()) {
-            size_t len2 = count_length(this->begin(), index);
-            basic_vector<T>::expand(size_ * 2);
-            index = this->begin() + len2;
-        }
+        // move elements backward, the capacity is checked in open_gap
+        basic_vector<T, Allocator, Growth>::open_gap(pos, len);
+
+        // place elements in the gap
+        basic_vector<T, Allocator, Growth>::template fill_gap<false>(pos, len, begin);
 
-        // move elements backward
-        for (iterator i = this->end() - 1, j = i - len; i >= index + len; --i, --j) {
-            *i = *j;
+        return this->begin() + (pos + len);
+    }
+
+    template <typename T, typename Allocator, typename Growth> template <typename Range>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::insert_range(iterator index, Range&& range) {
+        if (index > this->end()) {
+            return iterator();
         }
 
-        // place elements in the gap
-        for (auto itr = begin; itr != end ; ++index, ++itr) {
-            *index = *itr;
+        auto first = std::begin(range);
+        size_t len;
+        if constexpr (has_size_v<std::remove_reference_t<Range>>) {
+            len = range.size();
+        } else {
+            len = count_length(first, std::end(range));
         }
+        size_t pos = index - this->begin();
+
+        basic_vector<T, Allocator, Growth>::open_gap(pos, len);
+        basic_vector<T, Allocator, Growth>::template fill_gap<!std::is_lvalue_reference<Range>::value>(pos, len, first);
 
-        return index;
+        return this->begin() + (pos + len);
     }
 
-    template <typename T>
-    typename vector<T>::iterator vector<T>::remove(iterator index) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::remove(iterator index) noexcept {
         // check whether the position is valid
         if (index >= this->end()) {
             return iterator();
         }
 
-        // move the following elements
-        for (iterator i = index; i != this->end() - 1; ++i) {
-            *i = std::move(*(i + 1));
-        }
-        --size_;
+        // destroy the element and move the following elements
+        size_t pos = index - this->begin();
+        basic_vector<T, Allocator, Growth>::close_gap(pos, 1);
 
-        return index;
+        return this->begin() + pos;
     }
 
-    template <typename T>
-    typename vector<T>::iterator vector<T>::remove(iterator begin, iterator stop) noexcept {
+    template <typename T, typename Allocator, typename Growth>
+    typename vector<T, Allocator, Growth>::iterator vector<T, Allocator, Growth>::remove(iterator begin, iterator stop) noexcept {
         // check whether the range is valid
         if (begin >= stop || begin >= this->end() || stop > this->end()) {
             return iterator();
         }
 
-        // move the elements
-        size_t wid = count_length(begin, stop);
-        auto itr1 = begin;
-        auto itr2 = stop;
-        while (itr2 != this->end()) {
-            *(itr1++) = std::move(*(itr2++));
-        }
-
-        size_ -= wid;
-        return begin;
-    }
-
-    template <typename T>
-    vector<T>::const_iterator::const_iterator() : elem_(nullptr) {}
-
-    template <typename T>
-    vector<T>::const_iterator::const_iterator(const T* elem) : elem_(elem) {}
-
-    template <typename T>
-    vector<T>::const_iterator::const_iterator(const const_iterator& ci) : elem_{ci.elem_} {}
-
-    template <typename T>
-    vector<T>::const_iterator::const_iterator(const_iterator&& ci) noexcept : elem_(ci.elem_) {
-        ci.elem_ = nullptr;
-    }
-
-    template <typename T>
-    const T& vector<T>::const_iterator::operator*() const {
-        return *elem_;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator=(const const_iterator& ci) {
-        elem_ = ci.elem_;
-        return *this;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator=(const_iterator&& ci) noexcept{
-        elem_ = ci.elem_;
-        return *this;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator+=(size_t n) {
-        elem_ += n;
-        return *this;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator-=(size_t n) {
-        elem_ -= n;
-        return *this;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator vector<T>::const_iterator::operator+(size_t n) {
-        auto new_itr = *this;
-        new_itr += n;
-        return new_itr;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator vector<T>::const_iterator::operator-(size_t n) {
-        auto new_itr = *this;
-        new_itr -= n;
-        return new_itr;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator++() {
-        ++elem_;
-        return *this;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator vector<T>::const_iterator::operator++(int) {
-        auto old = *this;
-        ++elem_;
-        return old;
-    }
-
-    template <typename T>
-    typename vector<T>::const_iterator& vector<T>::const_iterator::operator--() {
-        --elem_;
-        return *this;
-    }
+        // destroy the range and move the elements
+        size_t pos = begin - this->begin();
+        size_t wid = stop - begin;
+        basic_vector<T, Allocator, Growth>::close_gap(pos, wid);
 
-    template <typename T>
-    typename vector<T>::const_iterator vector<T>::const_iterator::operator--(int) {
-        auto old = *this;
-        --elem_;
-        return old;
+        return this->begin() + pos;
     }
 
-    template <typename T>
-    vector<T>::iterator::iterator(T* elem) : const_iterator(elem) {}
-
-    template <typename T>
-    vector<T>::iterator::iterator(const iterator& itr) : const_iterator(itr) {}
-
-    template <typename T>
-    vector<T>::iterator::iterator(iterator&& itr) noexcept : const_iterator(std::move(itr)) {}
-
-    template <typename T>
-    typename vector<T>::iterator& vector<T>::iterator::operator=(const iterator& itr) {
-        const_iterator::operator=(itr);
-        return *this;
+    template <typename T, typename Allocator, typename Growth> template <typename Range>
+    size_t vector<T, Allocator, Growth>::remove_indices(const Range& indices) {
+        auto next = std::begin(indices);
+        auto last = std::end(indices);
+        // the indices are walked along with the elements
+        return basic_vector<T, Allocator, Growth>::compact([&next, &last](size_t index, T&) {
+            while (next != last && static_cast<size_t>(*next) < index) {
+                ++next;
+            }
+            return next != last && static_cast<size_t>(*next) == index;
+        });
     }
 
-    template <typename T>
-    typename vector<T>::iterator& vector<T>::iterator::operator=(iterator&& itr) noexcept {
-        const_iterator::operator=(std::move(itr));
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(const vector<T, Allocator, Growth>& vec) {
+        basic_vector<T, Allocator, Growth>::operator=(vec);
         return *this;
     }
 
-    template <typename T>
-    typename vector<T>::iterator& vector<T>::iterator::operator++() {
-        const_iterator::operator++();
+    template <typename T, typename Allocator, typename Growth>
+    vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(vector<T, Allocator, Growth>&& vec)
+        noexcept(basic_vector<T, Allocator, Growth>::nothrow_move_assignable) {
+        basic_vector<T, Allocator, Growth>::operator=(std::move(vec));
         return *this;
     }
 
-    template <typename T>
-    typename vector<T>::iterator vector<T>::iterator::operator++(int) {
-        auto old = *this;
-        const_iterator::operator++();
-        return old;
-    }
-
-    template <typename T>
-    typename vector<T>::iterator& vector<T>::iterator::operator--() {
-        const_iterator::operator--();
+    template <typename T, typename Allocator, typename Growth> template <size_t N>
+    vector<T, Allocator, Growth>& vector<T, Allocator, Growth>::operator=(small_vector<T, N, Allocator, Growth>&& vec) {
+        if (this != &vec) {
+            basic_vector<T, Allocator, Growth>::release();
+            basic_vector<T, Allocator, Growth>::move_from(vec);
+        }
         return *this;
     }
-
-    template <typename T>
-    typename vector<T>::iterator vector<T>::iterator::operator--(int) {
-        auto old = *this;
-        const_iterator::operator--();
-        return old;
-    }
 }
 #endif //VECTOR_H
@@ -0,0 +1,299 @@
+#ifndef MTL_VECTOR_ITERATOR_H
+#define MTL_VECTOR_ITERATOR_H
+
+#include <cstddef>
+#include <iterator>
+#include <utility>
+
+namespace mtl {
+    typedef std::size_t size_t;
+
+    /* the iterator of the contiguous containers that cannot modify the element it refers but can change which object if refers */
+    template <typename T>
+    class vector_const_iterator {
+    private:
+        const T* elem_;   // pointer to the element
+    public:
+        // the member types read by std::iterator_traits, so the algorithms take the random access paths
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T* pointer;
+        typedef const T& reference;
+
+        vector_const_iterator();
+        virtual ~vector_const_iterator() = default;
+
+        // construct from pointer
+        explicit vector_const_iterator(const T* elem);   
+
+        vector_const_iterator(const vector_const_iterator& ci);
+        vector_const_iterator(vector_const_iterator&& ci) noexcept;
+        // return a reference to the element           
+        const T& operator*() const;   
+
+        const T* operator->() const {
+            return elem_;
+        }
+
+        // the element n items next, it don't check the boundary
+        const T& operator[](difference_type n) const {
+            return elem_[n];
+        }
+
+        // compare the pointer
+        bool operator>(const vector_const_iterator& ci) const {
+            return elem_ > ci.elem_;
+        }
+
+        // compare the pointer
+        bool operator<(const vector_const_iterator& ci) const {
+            return elem_ < ci.elem_;
+        }
+
+        // compare the pointer
+        bool operator<=(const vector_const_iterator& ci) const {
+            return elem_ <= ci.elem_;
+        }
+
+        // compare the pointer
+        bool operator>=(const vector_const_iterator& ci) const {
+            return elem_ >= ci.elem_;
+        }
+
+        // compare the pointer
+        bool operator==(const vector_const_iterator& ci) const {
+            return elem_ == ci.elem_;
+        }
+
+        // compare the pointer
+        bool operator!=(const vector_const_iterator& ci) const {
+            return elem_ != ci.elem_;
+        }
+
+        explicit operator bool() const {
+            return elem_;
+        }
+
+        vector_const_iterator& operator=(const vector_const_iterator& ci);
+        vector_const_iterator& operator=(vector_const_iterator&& ci) noexcept;
+
+        // move n items next, it don't check the boundary
+        vector_const_iterator operator+(difference_type n) const;
+        // move n items next, it don't check the boundary
+        vector_const_iterator& operator+=(difference_type n);
+        // move n items previous, it don't check the boundary
+        vector_const_iterator operator-(difference_type n) const;
+        // move n items previous, it don't check the boundary
+        vector_const_iterator& operator-=(difference_type n);
+
+        friend vector_const_iterator operator+(difference_type n, const vector_const_iterator& ci) {
+            return ci + n;
+        }
+
+        // the number of elements from ci to this iterator
+        std::ptrdiff_t operator-(const vector_const_iterator& ci) const {
+            return elem_ - ci.elem_;
+        }
+
+        // prefix increment
+        vector_const_iterator& operator++();
+        // postfix increment
+        vector_const_iterator operator++(int);
+        // prefix decrement
+        vector_const_iterator& operator--();
+        // postfix decrement
+        vector_const_iterator operator--(int);
+    };
+
+    /* The normal iterator which derived from the vector_const_iterator 
+       Both the value of the element and which element it refers are modifiable */
+    template <typename T>
+    class vector_iterator : public vector_const_iterator<T> {
+    public:
+        typedef typename vector_const_iterator<T>::difference_type difference_type;
+        typedef T* pointer;
+        typedef T& reference;
+
+        using vector_const_iterator<T>::operator-;
+
+        vector_iterator() = default;
+        explicit vector_iterator(T* elem);
+        vector_iterator(const vector_iterator& itr);
+        vector_iterator(vector_iterator&& itr) noexcept;
+        ~vector_iterator() override = default;
+
+        T& operator*() const {
+            return const_cast<T&>(vector_const_iterator<T>::operator*());
+        }
+
+        T* operator->() const {
+            return const_cast<T*>(vector_const_iterator<T>::operator->());
+        }
+
+        T& operator[](difference_type n) const {
+            return const_cast<T&>(vector_const_iterator<T>::operator[](n));
+        }
+
+        vector_iterator& operator+=(difference_type n) {
+            vector_const_iterator<T>::operator+=(n);
+            return *this;
+        }
+        vector_iterator operator+(difference_type n) const {
+            auto new_itr = *this;
+            return new_itr.operator+=(n);
+        }
+        vector_iterator& operator-=(difference_type n) {
+            vector_const_iterator<T>::operator-=(n);
+            return *this;
+        }
+        vector_iterator operator-(difference_type n) const {
+            auto new_itr = *this;
+            return new_itr.operator-=(n);
+        } 
+
+        friend vector_iterator operator+(difference_type n, const vector_iterator& itr) {
+            return itr + n;
+        }
+
+        vector_iterator& operator=(const vector_iterator& itr);
+        vector_iterator& operator=(vector_iterator&& itr) noexcept;
+
+        vector_iterator& operator++();
+        vector_iterator operator++(int);
+        vector_iterator& operator--();
+        vector_iterator operator--(int);
+    };
+
+    template <typename T>
+    vector_const_iterator<T>::vector_const_iterator() : elem_(nullptr) {}
+
+    template <typename T>
+    vector_const_iterator<T>::vector_const_iterator(const T* elem) : elem_(elem) {}
+
+    template <typename T>
+    vector_const_iterator<T>::vector_const_iterator(const vector_const_iterator& ci) : elem_{ci.elem_} {}
+
+    template <typename T>
+    vector_const_iterator<T>::vector_const_iterator(vector_const_iterator&& ci) noexcept : elem_(ci.elem_) {
+        ci.elem_ = nullptr;
+    }
+
+    template <typename T>
+    const T& vector_const_iterator<T>::operator*() const {
+        return *elem_;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator=(const vector_const_iterator& ci) {
+        elem_ = ci.elem_;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator=(vector_const_iterator&& ci) noexcept{
+        elem_ = ci.elem_;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator+=(difference_type n) {
+        elem_ += n;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator-=(difference_type n) {
+        elem_ -= n;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T> vector_const_iterator<T>::operator+(difference_type n) const {
+        auto new_itr = *this;
+        new_itr += n;
+        return new_itr;
+    }
+
+    template <typename T>
+    vector_const_iterator<T> vector_const_iterator<T>::operator-(difference_type n) const {
+        auto new_itr = *this;
+        new_itr -= n;
+        return new_itr;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator++() {
+        ++elem_;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T> vector_const_iterator<T>::operator++(int) {
+        auto old = *this;
+        ++elem_;
+        return old;
+    }
+
+    template <typename T>
+    vector_const_iterator<T>& vector_const_iterator<T>::operator--() {
+        --elem_;
+        return *this;
+    }
+
+    template <typename T>
+    vector_const_iterator<T> vector_const_iterator<T>::operator--(int) {
+        auto old = *this;
+        --elem_;
+        return old;
+    }
+
+    template <typename T>
+    vector_iterator<T>::vector_iterator(T* elem) : vector_const_iterator<T>(elem) {}
+
+    template <typename T>
+    vector_iterator<T>::vector_iterator(const vector_iterator& itr) : vector_const_iterator<T>(itr) {}
+
+    template <typename T>
+    vector_iterator<T>::vector_iterator(vector_iterator&& itr) noexcept : vector_const_iterator<T>(std::move(itr)) {}
+
+    template <typename T>
+    vector_iterator<T>& vector_iterator<T>::operator=(const vector_iterator& itr) {
+        vector_const_iterator<T>::operator=(itr);
+        return *this;
+    }
+
+    template <typename T>
+    vector_iterator<T>& vector_iterator<T>::operator=(vector_iterator&& itr) noexcept {
+        vector_const_iterator<T>::operator=(std::move(itr));
+        return *this;
+    }
+
+    template <typename T>
+    vector_iterator<T>& vector_iterator<T>::operator++() {
+        vector_const_iterator<T>::operator++();
+        return *this;
+    }
+
+    template <typename T>
+    vector_iterator<T> vector_iterator<T>::operator++(int) {
+        auto old = *this;
+        vector_const_iterator<T>::operator++();
+        return old;
+    }
+
+    template <typename T>
+    vector_iterator<T>& vector_iterator<T>::operator--() {
+        vector_const_iterator<T>::operator--();
+        return *this;
+    }
+
+    template <typename T>
+    vector_iterator<T> vector_iterator<T>::operator--(int) {
+        auto old = *this;
+        vector_const_iterator<T>::operator--();
+        return old;
+    }
+}
+
+#endif
@@ -0,0 +1,109 @@
+#ifndef MTL_VECTOR_VIEW_H
+#define MTL_VECTOR_VIEW_H
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <mtl/vector_iterator.h>
+
+namespace mtl {
+    /* A non-owning view of a contiguous range of elements, e.g. a part of a vector. It's only a pointer and a length,
+       so it's cheap to copy and slicing it by subview never allocates or copies an element.
+       vector_view<const T> gives read-only access, and a vector_view<T> converts to it implicitly.
+       The view is invalidated whenever the array of the viewed container is reallocated.
+       It provides the same iterators as vector, so the algorithms work on it as well. */
+    template <typename T>
+    class vector_view {
+    public:
+        typedef std::remove_const_t<T> value_type;
+        typedef vector_const_iterator<value_type> const_iterator;
+        typedef std::conditional_t<std::is_const<T>::value, const_iterator, vector_iterator<value_type>> iterator;
+
+    private:
+        T* data_;
+        size_t size_;
+
+    public:
+        // an empty view
+        vector_view() noexcept : data_(nullptr), size_(0) {}
+
+        // view the size elements starting from data
+        vector_view(T* data, size_t size) noexcept : data_(data), size_(size) {}
+
+        // a view of mutable elements converts to a view of const ones
+        template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+        vector_view(const vector_view<U>& view) noexcept : data_(view.data()), size_(view.size()) {}
+
+        [[nodiscard]] bool empty() const {
+            return size_ == 0;
+        }
+
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        T* data() const {
+            return data_;
+        }
+
+        // it don't check the boundary
+        T& operator[](size_t index) const {
+            return data_[index];
+        }
+
+        // check the boundary, it throw an out_of_range exception
+        T& at(size_t index) const {
+            if (index < size_) {
+                return data_[index];
+            } else {
+                throw std::out_of_range("The index is out of range.");
+            }
+        }
+
+        T& front() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this view.");
+            }
+            return data_[0];
+        }
+
+        T& back() const {
+            if (empty()) {
+                throw std::out_of_range("There's no element in this view.");
+            }
+            return data_[size_ - 1];
+        }
+
+        /* return a view of the elements [begin, stop) of this view, nothing is copied
+           it throw an out_of_range exception if the range is not in this view */
+        vector_view<T> subview(size_t begin, size_t stop) const {
+            if (begin > stop || stop > size_) {
+                throw std::out_of_range("The range is out of the view.");
+            }
+            return vector_view<T>(data_ + begin, stop - begin);
+        }
+
+        // return a view of the elements from begin to the end of this view
+        vector_view<T> subview(size_t begin) const {
+            return subview(begin, size_);
+        }
+
+        const_iterator cbegin() const {
+            return const_iterator(data_);
+        }
+
+        const_iterator cend() const {
+            return const_iterator(data_ + size_);
+        }
+
+        iterator begin() const {
+            return iterator(data_);
+        }
+
+        iterator end() const {
+            return iterator(data_ + size_);
+        }
+    };
+}
+
+#endif
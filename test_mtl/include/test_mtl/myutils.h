@@ -2,7 +2,9 @@
 #define MYUTILS_H
 
 #include <mtl/vector.h>
+#include <cstddef>
 #include <iostream>
+#include <new>
 
 using namespace mtl;
 using std::ostream;
@@ -10,8 +12,8 @@ using std::ostream;
 /* To print the basic information fo a vector and all of its elements. 
    Type T: it should overload the operator<<.
 */
-template <typename T>
-void print_vector(ostream& os, const vector<T>& v);
+template <typename T, typename Allocator>
+void print_vector(ostream& os, const vector<T, Allocator>& v);
 
 /* To print the basic information of a container and all of its elements. 
     Type Container: it should provide begin() and end(), which return a iterator.
@@ -19,8 +21,90 @@ void print_vector(ostream& os, const vector<T>& v);
 template <typename Container>
 void print(ostream& os, const Container& c);
 
+/* The counters shared by all the counting_allocators. */
+struct allocation_stats {
+    static inline std::size_t allocations = 0;
+    static inline std::size_t deallocations = 0;
+    // the bytes which are allocated but not freed yet
+    static inline std::size_t live_bytes = 0;
+};
+
+/* An allocator which gets memory from the global operator new and records every request in allocation_stats. */
+template <typename T>
+class counting_allocator {
+public:
+    typedef T value_type;
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        ++allocation_stats::allocations;
+        allocation_stats::live_bytes += n * sizeof(T);
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        ++allocation_stats::deallocations;
+        allocation_stats::live_bytes -= n * sizeof(T);
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const counting_allocator<T>&, const counting_allocator<U>&) {
+    return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const counting_allocator<T>&, const counting_allocator<U>&) {
+    return false;
+}
+
+/* An allocator of a numbered pool, the ones of different pools can't free the memory of each other
+   and they don't propagate, so a container moved into one of another pool has to move its elements. */
 template <typename T>
-void print_vector(ostream& os, const vector<T>& v) {
+class pool_allocator {
+public:
+    typedef T value_type;
+
+    int pool;
+
+    explicit pool_allocator(int p = 0) noexcept : pool(p) {}
+
+    template <typename U>
+    pool_allocator(const pool_allocator<U>& alloc) noexcept : pool(alloc.pool) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p);
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const pool_allocator<T>& a, const pool_allocator<U>& b) {
+    return a.pool == b.pool;
+}
+
+template <typename T, typename U>
+bool operator!=(const pool_allocator<T>& a, const pool_allocator<U>& b) {
+    return a.pool != b.pool;
+}
+
+// To print the counters of the counting_allocators.
+inline void print_allocation_stats(ostream& os) {
+    os << "allocations: " << allocation_stats::allocations
+       << ", deallocations: " << allocation_stats::deallocations
+       << ", live bytes: " << allocation_stats::live_bytes << std::endl;
+}
+
+template <typename T, typename Allocator>
+void print_vector(ostream& os, const vector<T, Allocator>& v) {
     using std::endl;
     os << "The size: " << v.size()
        << "\nThe capacity: " << v.capacity()
@@ -9,4 +9,9 @@ using std::ostream;
 
 void test_quicksort(ostream& os);
 void test_mergesort(ostream& os);
+void test_iterator_traits(ostream& os);
+void test_introsort(ostream& os);
+void test_pdqsort(ostream& os);
+void test_radix_sort(ostream& os);
+void test_parallel_sort(ostream& os);
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef TEST_BITVECTOR_H
+#define TEST_BITVECTOR_H
+
+#include <iostream>
+#include <mtl/bitvector.h>
+
+using std::ostream;
+
+void test_bits(ostream& os);
+void test_rank_select(ostream& os);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_CONCURRENT_VECTOR_H
+#define TEST_CONCURRENT_VECTOR_H
+
+#include <iostream>
+#include <mtl/concurrent_vector.h>
+
+using std::ostream;
+
+void test_single_thread(ostream& os);
+void test_concurrent_push(ostream& os);
+
+#endif
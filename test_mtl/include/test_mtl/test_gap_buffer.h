@@ -0,0 +1,12 @@
+#ifndef TEST_GAP_BUFFER_H
+#define TEST_GAP_BUFFER_H
+
+#include <iostream>
+#include <mtl/gap_buffer.h>
+
+using std::ostream;
+
+void test_editing(ostream& os);
+void test_copy_move(ostream& os);
+
+#endif
@@ -9,5 +9,6 @@ void test_constructor(ostream& os);
 void test_push_pop(ostream& os);
 void test_iterator(ostream& os);
 void test_insert_remove(ostream& os);
+void test_allocator(ostream& os);
 
 #endif
\ No newline at end of file
@@ -0,0 +1,12 @@
+#ifndef TEST_MMAP_VECTOR_H
+#define TEST_MMAP_VECTOR_H
+
+#include <iostream>
+#include <mtl/mmap_vector.h>
+
+using std::ostream;
+
+void test_persistence(ostream& os);
+void test_algorithms(ostream& os);
+
+#endif
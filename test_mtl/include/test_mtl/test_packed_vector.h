@@ -0,0 +1,13 @@
+#ifndef TEST_PACKED_VECTOR_H
+#define TEST_PACKED_VECTOR_H
+
+#include <iostream>
+#include <mtl/packed_vector.h>
+#include <mtl/delta_vector.h>
+
+using std::ostream;
+
+void test_packed(ostream& os);
+void test_delta(ostream& os);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TEST_PERSISTENT_VECTOR_H
+#define TEST_PERSISTENT_VECTOR_H
+
+#include <iostream>
+#include <mtl/persistent_vector.h>
+
+using std::ostream;
+
+void test_versions(ostream& os);
+void test_concat_slice(ostream& os);
+void test_transient(ostream& os);
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef TEST_SMALL_VECTOR_H
+#define TEST_SMALL_VECTOR_H
+
+#include <iostream>
+#include <mtl/small_vector.h>
+#include <mtl/static_vector.h>
+
+using std::ostream;
+
+void test_inline_spill(ostream& os);
+void test_copy_move(ostream& os);
+void test_static_vector(ostream& os);
+
+#endif
@@ -0,0 +1,12 @@
+#ifndef TEST_SOA_VECTOR_H
+#define TEST_SOA_VECTOR_H
+
+#include <iostream>
+#include <mtl/soa_vector.h>
+
+using std::ostream;
+
+void test_rows(ostream& os);
+void test_columns(ostream& os);
+
+#endif
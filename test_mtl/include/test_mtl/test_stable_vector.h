@@ -0,0 +1,12 @@
+#ifndef TEST_STABLE_VECTOR_H
+#define TEST_STABLE_VECTOR_H
+
+#include <iostream>
+#include <mtl/stable_vector.h>
+
+using std::ostream;
+
+void test_stable_addresses(ostream& os);
+void test_algorithms(ostream& os);
+
+#endif
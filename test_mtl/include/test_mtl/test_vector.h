@@ -10,5 +10,13 @@ void test_constructor(ostream& os);
 void test_push_pop_shrink(ostream& os);
 void test_iterator(ostream& os);
 void test_insert_remove(ostream& os);
+void test_allocator(ostream& os);
+void test_growth(ostream& os);
+void test_alignment(ostream& os);
+void test_reserve_resize(ostream& os);
+void test_insert_range(ostream& os);
+void test_view(ostream& os);
+void test_cow(ostream& os);
+void test_remove_if(ostream& os);
 
 #endif
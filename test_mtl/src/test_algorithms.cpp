@@ -2,10 +2,30 @@
 #include <test_mtl/myutils.h>
 #include <mtl/algorithms.h>
 #include <mtl/vector.h>
+#include <mtl/list.h>
+#include <mtl/stable_vector.h>
+#include <mtl/gap_buffer.h>
+#include <mtl/persistent_vector.h>
+#include <mtl/radix_sort.h>
+#include <mtl/parallel_sort.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
 #include <fstream>
+#include <string>
 #include <random>
+#include <stdexcept>
 #include <chrono>
 
+using std::endl;
+
 void test_quicksort(ostream& os) {
     mtl::vector<int> vec;
     using namespace std::chrono;
@@ -52,6 +72,447 @@ void test_mergesort(ostream& os) {
 
     os << "after sorting: \n";
     print(os, vec);
+
+    // the iterators of these containers have std among their associated namespaces, <algorithm> is included,
+    // so the helpers mustn't be found by argument-dependent lookup
+    os << "\nsort the containers whose iterators bring std::inplace_merge into the lookup: \n";
+    mtl::vector<int> nums;
+    mtl::stable_vector<int, 8> stable;
+    mtl::gap_buffer<int> gap;
+    mtl::vector<std::string> words;
+    for (int i = 0; i < 100; ++i) {
+        int x = uid(e);
+        nums.push_back(x);
+        stable.push_back(x);
+        gap.push_back(x);
+        words.push_back(std::to_string(x));
+    }
+    mtl::inplace_mergesort(nums.begin(), nums.end());
+    mtl::inplace_mergesort(stable.begin(), stable.end());
+    mtl::inplace_mergesort(gap.begin(), gap.end());
+    mtl::inplace_mergesort(words.begin(), words.end());
+    os << "the same as on vector<int>, stable_vector: " << std::equal(stable.begin(), stable.end(), nums.begin())
+       << ", gap_buffer: " << std::equal(gap.begin(), gap.end(), nums.begin()) << "\n";
+    bool ascending = std::is_sorted(nums.begin(), nums.end());
+    os << "vector<string> in the same order as vector<int>: "
+       << (ascending ? std::is_sorted(words.begin(), words.end())
+                     : std::is_sorted(words.begin(), words.end(), std::greater<std::string>())) << "\n";
+    std::shuffle(stable.begin(), stable.end(), e);
+    std::shuffle(words.begin(), words.end(), e);
+    mtl::inplace_quicksort(stable.begin(), stable.end());
+    mtl::pdqsort(words.begin(), words.end());
+    os << "quicksort on stable_vector: " << std::is_sorted(stable.begin(), stable.end())
+       << ", pdqsort on vector<string>: " << std::is_sorted(words.begin(), words.end()) << "\n";
+}
+
+void test_iterator_traits(ostream& os) {
+    os << "1. the iterator categories" << endl;
+    os << "vector: " << mtl::is_random_access_iterator_v<mtl::vector<int>::iterator>
+       << ", vector const: " << mtl::is_random_access_iterator_v<mtl::vector<int>::const_iterator>
+       << ", stable_vector: " << mtl::is_random_access_iterator_v<mtl::stable_vector<int>::iterator>
+       << ", persistent_vector: " << mtl::is_random_access_iterator_v<mtl::persistent_vector<int>::iterator>
+       << ", list: " << mtl::is_random_access_iterator_v<mtl::list<int>::iterator>
+       << ", list bidirectional: "
+       << std::is_same<std::iterator_traits<mtl::list<int>::iterator>::iterator_category,
+                       std::bidirectional_iterator_tag>::value << endl;
+
+    os << "\n2. count_length and find_mid take O(1) on the random access iterators" << endl;
+    mtl::vector<int> vec;
+    mtl::list<int> lst;
+    for (int i = 0; i < 11; ++i) {
+        vec.push_back(i);
+        lst.push_back(i);
+    }
+    os << "vector length: " << mtl::count_length(vec.begin(), vec.end()) << ", mid: " << *mtl::find_mid(vec.begin(), vec.end())
+       << endl;
+    os << "list length: " << mtl::count_length(lst.begin(), lst.end()) << ", mid: " << *mtl::find_mid(lst.begin(), lst.end())
+       << endl;
+
+    os << "\n3. the std algorithms on the mtl iterators" << endl;
+    std::reverse(vec.begin(), vec.end());
+    print(os, vec);
+    std::sort(vec.begin(), vec.end());
+    print(os, vec);
+    auto found = std::lower_bound(vec.cbegin(), vec.cend(), 7);
+    os << "lower_bound(7) at " << (found - vec.cbegin()) << ", distance: " << std::distance(vec.begin(), vec.end())
+       << ", accumulate: " << std::accumulate(vec.begin(), vec.end(), 0) << endl;
+    std::reverse(lst.begin(), lst.end());
+    print(os, lst);
+    os << "find 3 in the list: " << std::distance(lst.begin(), std::find(lst.begin(), lst.end(), 3)) << endl;
+
+    mtl::stable_vector<int, 4> stable;
+    for (int i = 0; i < 20; ++i) {
+        stable.push_back((i * 7) % 20);
+    }
+    std::sort(stable.begin(), stable.end());
+    print(os, stable);
+    mtl::persistent_vector<int> pv{5, 3, 9, 1};
+    os << "max in the persistent_vector: " << *std::max_element(pv.begin(), pv.end()) << endl;
+
+    os << "\n4. mergesort a list through the bidirectional path" << endl;
+    mtl::list<int> lst2;
+    for (int i = 0; i < 10; ++i) {
+        lst2.push_back((i * 3) % 10);
+    }
+    mtl::inplace_mergesort(lst2.begin(), lst2.end());
+    print(os, lst2);
+}
+
+// whether the elements are in ascending order
+template <typename Container>
+bool ascending(const Container& c) {
+    return std::is_sorted(c.begin(), c.end());
+}
+
+void test_introsort(ostream& os) {
+    const int n = 1000000;
+    os << "1. the inputs which make the first-element pivot quadratic, " << n << " numbers each" << endl;
+    mtl::vector<int> sorted;
+    mtl::vector<int> reversed;
+    mtl::vector<int> equal;
+    mtl::vector<int> organ_pipe;
+    for (int i = 0; i < n; ++i) {
+        sorted.push_back(i);
+        reversed.push_back(n - i);
+        equal.push_back(7);
+        organ_pipe.push_back(i < n / 2 ? i : n - i);
+    }
+    mtl::inplace_quicksort(sorted.begin(), sorted.end());
+    mtl::inplace_quicksort(reversed.begin(), reversed.end());
+    mtl::inplace_quicksort(equal.begin(), equal.end());
+    mtl::inplace_quicksort(organ_pipe.begin(), organ_pipe.end());
+    os << "sorted: " << ascending(sorted) << ", reversed: " << ascending(reversed) << ", equal: " << ascending(equal)
+       << ", organ pipe: " << ascending(organ_pipe) << endl;
+
+    os << "\n2. random numbers and strings" << endl;
+    std::default_random_engine e(42);
+    std::uniform_int_distribution<> uid(-1000, 1000);
+    mtl::vector<int> random;
+    for (int i = 0; i < n; ++i) {
+        random.push_back(uid(e));
+    }
+    long long sum = std::accumulate(random.begin(), random.end(), 0LL);
+    mtl::inplace_quicksort(random.begin(), random.end());
+    os << "random: " << ascending(random)
+       << ", the same elements: " << (sum == std::accumulate(random.begin(), random.end(), 0LL)) << endl;
+    mtl::vector<std::string> words({"pear", "apple", "fig", "kiwi", "banana", "cherry", "date", "grape", "lemon",
+                                    "mango", "melon", "olive", "peach", "plum", "quince", "lime", "lychee", "nut"});
+    mtl::inplace_quicksort(words.begin(), words.end());
+    print(os, words);
+
+    os << "\n3. the small ranges, insertion sort and heapsort" << endl;
+    for (int len = 0; len < 40; ++len) {
+        mtl::vector<int> small;
+        for (int i = 0; i < len; ++i) {
+            small.push_back((i * 17) % 11);
+        }
+        mtl::inplace_quicksort(small.begin(), small.end());
+        if (!ascending(small)) {
+            os << "length " << len << " is not sorted" << endl;
+        }
+    }
+    mtl::vector<int> heap({5, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5});
+    mtl::heapsort(heap.begin(), heap.end());
+    print(os, heap);
+    mtl::vector<int> ins({3, 1, 2});
+    mtl::insertion_sort(ins.begin(), ins.end());
+    print(os, ins);
+
+    os << "\n4. a list goes through the plain quicksort" << endl;
+    mtl::list<int> lst;
+    for (int i = 0; i < 10; ++i) {
+        lst.push_back((i * 7) % 10);
+    }
+    mtl::inplace_quicksort(lst.begin(), lst.end());
+    print(os, lst);
+}
+
+// an int which counts the comparisons
+struct counted {
+    static long long comparisons;
+    int value;
+
+    bool operator<(const counted& other) const {
+        ++comparisons;
+        return value < other.value;
+    }
+};
+
+long long counted::comparisons = 0;
+
+// the inputs of n elements in different patterns
+mtl::vector<int> make_pattern(const std::string& name, int n) {
+    std::default_random_engine e(7);
+    std::uniform_int_distribution<> uid(0, n);
+    mtl::vector<int> vec;
+    for (int i = 0; i < n; ++i) {
+        if (name == "sorted") {
+            vec.push_back(i);
+        } else if (name == "reversed") {
+            vec.push_back(n - i);
+        } else if (name == "equal") {
+            vec.push_back(7);
+        } else if (name == "few distinct") {
+            vec.push_back(uid(e) % 4);
+        } else if (name == "organ pipe") {
+            vec.push_back(i < n / 2 ? i : n - i);
+        } else if (name == "sawtooth") {
+            vec.push_back(i % 1000);
+        } else if (name == "sorted with noise") {
+            vec.push_back(i % 100 == 0 ? uid(e) : i);
+        } else {
+            vec.push_back(uid(e));
+        }
+    }
+    return vec;
+}
+
+void test_pdqsort(ostream& os) {
+    const int n = 300000;
+    const std::string patterns[] = {"sorted", "reversed", "equal", "few distinct", "organ pipe", "sawtooth",
+                                    "sorted with noise", "random"};
+
+    os << "1. the same result as std::sort on " << n << " ints, doubles and strings" << endl;
+    for (const auto& name : patterns) {
+        auto vec = make_pattern(name, n);
+        mtl::vector<double> doubles;
+        mtl::vector<std::string> strings;
+        for (int i = 0; i < n; ++i) {
+            doubles.push_back(vec[i] * 0.5 - 100);
+            if (i < n / 10) {
+                strings.push_back(std::to_string(vec[i]));
+            }
+        }
+        auto expected = vec;
+        std::sort(expected.begin(), expected.end());
+        auto expected_strings = strings;
+        std::sort(expected_strings.begin(), expected_strings.end());
+
+        mtl::pdqsort(vec.begin(), vec.end());
+        mtl::pdqsort(doubles.begin(), doubles.end());
+        mtl::pdqsort(strings.begin(), strings.end());
+        bool same = std::equal(vec.begin(), vec.end(), expected.begin());
+        os << name << ": ints " << same << ", doubles " << ascending(doubles) << ", strings "
+           << std::equal(strings.begin(), strings.end(), expected_strings.begin()) << endl;
+    }
+
+    os << "\n2. the comparisons per element, the sorted, reversed and few distinct keys take about O(n)" << endl;
+    for (const auto& name : patterns) {
+        auto vec = make_pattern(name, n);
+        mtl::vector<counted> items;
+        for (int i = 0; i < n; ++i) {
+            items.push_back(counted{vec[i]});
+        }
+        counted::comparisons = 0;
+        mtl::pdqsort(items.begin(), items.end());
+        bool sorted = std::is_sorted(items.begin(), items.end());
+        double per_element = double(counted::comparisons) / n;
+        os << name << ": " << sorted << ", " << (per_element < 8 ? "linear" : "n log n") << endl;
+    }
+
+    os << "\n3. the short ranges" << endl;
+    for (int len = 0; len < 200; ++len) {
+        mtl::vector<int> vec;
+        for (int i = 0; i < len; ++i) {
+            vec.push_back((i * 37) % 23);
+        }
+        mtl::pdqsort(vec.begin(), vec.end());
+        if (!ascending(vec)) {
+            os << "length " << len << " is not sorted" << endl;
+        }
+    }
+    mtl::vector<int> small({3, 9, 1, 7, 5});
+    mtl::pdqsort(small.begin(), small.end());
+    print(os, small);
+
+    os << "\n4. the time of sorting " << n << " random ints" << endl;
+    using namespace std::chrono;
+    auto vec = make_pattern("random", n);
+    auto vec2 = vec;
+    auto start = system_clock::now();
+    mtl::inplace_quicksort(vec.begin(), vec.end());
+    auto introsort_time = duration_cast<microseconds>(system_clock::now() - start);
+    start = system_clock::now();
+    mtl::pdqsort(vec2.begin(), vec2.end());
+    auto pdqsort_time = duration_cast<microseconds>(system_clock::now() - start);
+    os << "introsort: " << introsort_time.count() << "us, pdqsort: " << pdqsort_time.count() << "us" << endl;
+}
+
+// a record sorted by its key, the name tells the original order
+struct record {
+    std::int64_t key;
+    std::string name;
+};
+
+void test_radix_sort(ostream& os) {
+    const int n = 200000;
+    std::default_random_engine e(11);
+
+    os << "1. the integers and floats, compared with std::sort" << endl;
+    std::uniform_int_distribution<std::uint64_t> u64;
+    mtl::vector<std::uint32_t> u32s;
+    mtl::vector<std::uint64_t> u64s;
+    mtl::vector<int> ints;
+    mtl::vector<double> doubles;
+    mtl::vector<float> floats;
+    for (int i = 0; i < n; ++i) {
+        auto r = u64(e);
+        u32s.push_back(static_cast<std::uint32_t>(r));
+        u64s.push_back(r);
+        ints.push_back(static_cast<int>(r % 2001) - 1000);
+        doubles.push_back((static_cast<double>(r % 100000) - 50000) / 7);
+        floats.push_back(static_cast<float>(static_cast<std::int64_t>(r >> 11) - (std::int64_t(1) << 52)));
+    }
+    doubles[0] = -0.0;
+    doubles[1] = 0.0;
+    doubles[2] = std::numeric_limits<double>::infinity();
+    doubles[3] = -std::numeric_limits<double>::infinity();
+    doubles[4] = std::numeric_limits<double>::lowest();
+    auto check = [&os](const char* name, auto& vec) {
+        auto expected = vec;
+        std::sort(expected.begin(), expected.end());
+        mtl::radix_sort(vec.begin(), vec.end());
+        os << name << ": " << std::equal(vec.begin(), vec.end(), expected.begin()) << endl;
+    };
+    check("uint32_t", u32s);
+    check("uint64_t", u64s);
+    check("int", ints);
+    check("double", doubles);
+    check("float", floats);
+    auto zero = std::lower_bound(doubles.begin(), doubles.end(), 0.0);
+    os << "-0.0 before 0.0: " << (std::signbit(zero[0]) && !std::signbit(zero[1])) << endl;
+
+    os << "\n2. the records by a key, it's stable" << endl;
+    mtl::vector<record> records;
+    for (int i = 0; i < n; ++i) {
+        records.push_back(record{static_cast<std::int64_t>(u64(e) % 1000) - 500, std::to_string(i)});
+    }
+    auto expected = records;
+    auto by_key = [](const record& a, const record& b) { return a.key < b.key; };
+    std::stable_sort(expected.begin(), expected.end(), by_key);
+    mtl::radix_sort(records.begin(), records.end(), [](const record& r) { return r.key; });
+    bool same = true;
+    for (int i = 0; i < n; ++i) {
+        same = same && records[i].key == expected[i].key && records[i].name == expected[i].name;
+    }
+    os << "int64_t key with string names: " << same << endl;
+
+    os << "\n3. the fixed-width keys, by LSD up to 8 bytes and by MSD for the longer ones" << endl;
+    mtl::vector<std::pair<std::uint32_t, std::int16_t>> pairs;
+    mtl::vector<std::array<std::uint32_t, 4>> arrays;
+    for (int i = 0; i < n; ++i) {
+        auto r = u64(e);
+        pairs.push_back({static_cast<std::uint32_t>(r % 100), static_cast<std::int16_t>(r >> 32)});
+        // the first words are mostly equal, so MSD has to go deep
+        arrays.push_back({7, static_cast<std::uint32_t>(r % 3), static_cast<std::uint32_t>(r >> 40),
+                          static_cast<std::uint32_t>(r)});
+    }
+    check("pair<uint32_t, int16_t>", pairs);
+    check("array<uint32_t, 4>", arrays);
+    mtl::vector<std::pair<std::array<std::uint64_t, 2>, std::string>> long_records;
+    for (int i = 0; i < n / 10; ++i) {
+        auto r = u64(e);
+        long_records.push_back({{r % 5, r % 50}, std::to_string(i)});
+    }
+    auto expected_long = long_records;
+    std::stable_sort(expected_long.begin(), expected_long.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    mtl::radix_sort(long_records.begin(), long_records.end(), [](const auto& r) { return r.first; });
+    os << "array<uint64_t, 2> key with string names: "
+       << std::equal(long_records.begin(), long_records.end(), expected_long.begin()) << endl;
+
+    os << "\n4. the same keys and the short ranges" << endl;
+    mtl::vector<std::uint64_t> same_keys;
+    for (int i = 0; i < 1000; ++i) {
+        same_keys.push_back(42);
+    }
+    mtl::radix_sort(same_keys.begin(), same_keys.end());
+    os << "all the same: " << ascending(same_keys) << endl;
+    mtl::vector<int> small({5, -3, 9, 0, -3, 2});
+    mtl::radix_sort(small.begin(), small.end());
+    print(os, small);
+
+    os << "\n5. the time of sorting " << n * 5 << " random uint64_t" << endl;
+    using namespace std::chrono;
+    mtl::vector<std::uint64_t> keys;
+    for (int i = 0; i < n * 5; ++i) {
+        keys.push_back(u64(e));
+    }
+    auto keys2 = keys;
+    auto start = system_clock::now();
+    mtl::radix_sort(keys.begin(), keys.end());
+    auto radix_time = duration_cast<microseconds>(system_clock::now() - start);
+    start = system_clock::now();
+    mtl::pdqsort(keys2.begin(), keys2.end());
+    auto pdqsort_time = duration_cast<microseconds>(system_clock::now() - start);
+    os << "radix_sort: " << radix_time.count() << "us, pdqsort: " << pdqsort_time.count() << "us" << endl;
+}
+
+void test_parallel_sort(ostream& os) {
+    const int n = 400000;
+    const std::string patterns[] = {"sorted", "reversed", "equal", "few distinct", "organ pipe", "sawtooth",
+                                    "sorted with noise", "random"};
+
+    os << "1. the same result as std::sort with 4 threads, " << n << " ints" << endl;
+    for (const auto& name : patterns) {
+        auto vec = make_pattern(name, n);
+        auto expected = vec;
+        std::sort(expected.begin(), expected.end());
+        mtl::parallel_sort(vec.begin(), vec.end(), 4);
+        os << name << ": " << std::equal(vec.begin(), vec.end(), expected.begin()) << endl;
+    }
+
+    os << "\n2. the strings, the short ranges and the thread counts" << endl;
+    mtl::vector<std::string> strings;
+    std::default_random_engine e(3);
+    std::uniform_int_distribution<> uid(0, 1000000);
+    for (int i = 0; i < n / 4; ++i) {
+        strings.push_back(std::to_string(uid(e)));
+    }
+    auto expected_strings = strings;
+    std::sort(expected_strings.begin(), expected_strings.end());
+    mtl::parallel_sort(strings.begin(), strings.end(), 8);
+    os << "strings: " << std::equal(strings.begin(), strings.end(), expected_strings.begin()) << endl;
+
+    mtl::vector<int> small({4, 8, 1, 9, 3});
+    mtl::parallel_sort(small.begin(), small.end(), 4);
+    print(os, small);
+
+    for (size_t threads : {size_t(0), size_t(1), size_t(2), size_t(3), size_t(16), size_t(100)}) {
+        auto vec = make_pattern("random", n);
+        mtl::parallel_sort(vec.begin(), vec.end(), threads);
+        os << threads << " threads: " << ascending(vec) << endl;
+    }
+
+    os << "\n3. the time of sorting " << n << " random ints, on " << std::thread::hardware_concurrency()
+       << " hardware threads" << endl;
+    using namespace std::chrono;
+    for (size_t threads : {size_t(1), size_t(2), size_t(4), size_t(8)}) {
+        auto vec = make_pattern("random", n);
+        auto start = system_clock::now();
+        mtl::parallel_sort(vec.begin(), vec.end(), threads);
+        auto time = duration_cast<microseconds>(system_clock::now() - start);
+        os << threads << " threads: " << time.count() << "us" << endl;
+    }
+
+    os << "\n4. parallel_run runs every part once, and joins the threads when the calling thread throws" << endl;
+    std::atomic<int> runs[8] = {};
+    mtl::parallel_run(8, [&runs](size_t i) { ++runs[i]; });
+    for (auto& r : runs) {
+        os << r << " ";
+    }
+    os << endl;
+    std::atomic<int> finished(0);
+    try {
+        mtl::parallel_run(4, [&finished](size_t i) {
+            if (i == 0) {
+                throw std::runtime_error("part 0 failed");
+            }
+            ++finished;
+        });
+    } catch (const std::runtime_error& ex) {
+        os << ex.what() << ", the finished threads: " << finished << endl;
+    }
 }
 
 int main() {
@@ -59,5 +520,20 @@ int main() {
     ofstream ofs("test_mergesort.txt");
     test_mergesort(ofs);
 
+    ofstream ofs2("test_iterator_traits.txt");
+    test_iterator_traits(ofs2);
+
+    ofstream ofs3("test_introsort.txt");
+    test_introsort(ofs3);
+
+    ofstream ofs4("test_pdqsort.txt");
+    test_pdqsort(ofs4);
+
+    ofstream ofs5("test_radix_sort.txt");
+    test_radix_sort(ofs5);
+
+    ofstream ofs6("test_parallel_sort.txt");
+    test_parallel_sort(ofs6);
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include <test_mtl/test_bitvector.h>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+using std::ostream;
+using std::ofstream;
+using mtl::bitvector;
+using std::endl;
+
+void print_bits(ostream& os, const bitvector& bits) {
+    os << "The size: " << bits.size() << ", ones: " << bits.count() << endl;
+    for (bool bit : bits) {
+        os << bit;
+    }
+    os << endl;
+}
+
+void test_bits(ostream& os) {
+    os << "1. push back 70 bits, every third is set" << endl;
+    bitvector bits;
+    for (int i = 0; i < 70; ++i) {
+        bits.push_back(i % 3 == 0);
+    }
+    print_bits(os, bits);
+
+    os << "\n2. set, reset, flip and test" << endl;
+    bits.set(1);
+    bits.reset(0);
+    bits.flip(69);
+    os << "bit 0: " << bits.test(0) << ", bit 1: " << bits.test(1) << ", bit 69: " << bits.test(69) << endl;
+    try {
+        bits.test(70);
+    } catch (std::out_of_range& e) {
+        os << "test(70): " << e.what() << endl;
+    }
+
+    os << "\n3. the bulk operations" << endl;
+    bitvector a(70, true);
+    bitvector b(70);
+    for (int i = 0; i < 70; i += 2) {
+        b.set(i);
+    }
+    bitvector c = a;
+    c &= b;
+    os << "all & evens == evens: " << (c == b) << endl;
+    c ^= a;
+    os << "count of evens ^ all: " << c.count() << endl;
+    c |= b;
+    os << "(odds | evens) == all: " << (c == a) << endl;
+    os << "count of ~evens: " << (~b).count() << endl;
+    a.flip();
+    os << "count of the flipped all: " << a.count() << ", the last word: " << b.data()[1] << endl;
+    try {
+        a &= bitvector(3);
+    } catch (std::invalid_argument& e) {
+        os << "different sizes: " << e.what() << endl;
+    }
+
+    os << "\n4. resize and pop back" << endl;
+    bitvector d;
+    d.resize(5, true);
+    d.resize(130, false);
+    d.resize(140, true);
+    os << "count: " << d.count() << ", size: " << d.size() << endl;
+    for (int i = 0; i < 12; ++i) {
+        d.pop_back();
+    }
+    os << "count after popping 12: " << d.count() << ", size: " << d.size() << endl;
+}
+
+void test_rank_select(ostream& os) {
+    os << "1. rank and select on 100000 pseudo-random bits" << endl;
+    bitvector bits;
+    std::vector<size_t> ones;
+    std::uint64_t seed = 12345;
+    for (size_t i = 0; i < 100000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        // long runs of zeros between the dense parts
+        bool bit = (i / 5000) % 3 != 2 && (seed >> 60) < 5;
+        bits.push_back(bit);
+        if (bit) {
+            ones.push_back(i);
+        }
+    }
+    bits.build_index();
+
+    bool rank_ok = true;
+    size_t expected = 0;
+    for (size_t i = 0; i <= bits.size(); ++i) {
+        if (bits.rank1(i) != expected) {
+            rank_ok = false;
+        }
+        if (i < bits.size() && bits[i]) {
+            ++expected;
+        }
+    }
+    bool select_ok = true;
+    for (size_t k = 0; k < ones.size(); ++k) {
+        if (bits.select1(k) != ones[k]) {
+            select_ok = false;
+        }
+    }
+    os << "ones: " << ones.size() << ", rank ok: " << rank_ok << ", select ok: " << select_ok << endl;
+    os << "rank1(50000): " << bits.rank1(50000) << ", rank0(50000): " << bits.rank0(50000) << endl;
+
+    os << "\n2. the boundary checks" << endl;
+    try {
+        bits.select1(ones.size());
+    } catch (std::out_of_range& e) {
+        os << "select1(" << ones.size() << "): " << e.what() << endl;
+    }
+    bits.flip(0);
+    try {
+        bits.rank1(10);
+    } catch (std::logic_error& e) {
+        os << "after a modification: " << e.what() << endl;
+    }
+
+    os << "\n3. a full bitvector" << endl;
+    bitvector full(1025, true);
+    full.build_index();
+    os << "rank1(1025): " << full.rank1(1025) << ", select1(1000): " << full.select1(1000) << endl;
+
+    os << "\n4. select on a sparse bitvector, the long spans between the samples keep their positions" << endl;
+    bitvector sparse(20000000);
+    std::vector<size_t> sparse_ones;
+    for (size_t i = 7; i < sparse.size(); i += i < 15000000 ? 1000 : 3) {
+        sparse.set(i);
+        sparse_ones.push_back(i);
+    }
+    sparse.build_index();
+    bool sparse_ok = true;
+    for (size_t k = 0; k < sparse_ones.size(); ++k) {
+        sparse_ok = sparse_ok && sparse.select1(k) == sparse_ones[k] && sparse.rank1(sparse_ones[k]) == k;
+    }
+    os << "ones: " << sparse_ones.size() << ", select ok: " << sparse_ok << endl;
+}
+
+int main() {
+    ofstream ofs1("bitvector_test_bits.txt");
+    test_bits(ofs1);
+
+    ofstream ofs2("bitvector_test_rank_select.txt");
+    test_rank_select(ofs2);
+
+    return 0;
+}
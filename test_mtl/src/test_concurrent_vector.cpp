@@ -0,0 +1,167 @@
+#include <test_mtl/test_concurrent_vector.h>
+#include <test_mtl/myutils.h>
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::ostream;
+using std::ofstream;
+using mtl::concurrent_vector;
+using std::endl;
+
+// its copies wait for the gate to open when blocking, as a writer preempted in the middle of an insertion
+struct gated {
+    static std::atomic<bool> open;
+    static std::atomic<bool> entered;
+
+    int value;
+    bool blocking;
+
+    gated(int v, bool b) : value(v), blocking(b) {}
+
+    gated(const gated& rhs) noexcept : value(rhs.value), blocking(false) {
+        if (rhs.blocking) {
+            entered = true;
+            while (!open.load()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    gated(gated&& rhs) noexcept : value(rhs.value), blocking(false) {}
+};
+
+std::atomic<bool> gated::open(false);
+std::atomic<bool> gated::entered(false);
+
+void test_single_thread(ostream& os) {
+    os << "1. push back 100 numbers across the segments" << endl;
+    concurrent_vector<int> vec;
+    int* first = &vec.push_back(0);
+    for (int i = 1; i < 100; ++i) {
+        vec.push_back(i);
+    }
+    os << "size: " << vec.size() << ", capacity: " << vec.capacity() << endl;
+    os << "front: " << vec.front() << ", back: " << vec.back() << ", vec[50]: " << vec[50] << endl;
+    os << "the first element stays at its address: " << (first == &vec[0] ? "yes" : "no") << endl;
+
+    os << "\n2. grow_by" << endl;
+    size_t index = vec.grow_by(3);
+    os << "grow_by(3) starts at " << index << ": " << vec[100] << " " << vec[101] << " " << vec[102] << endl;
+    index = vec.grow_by(2, 7);
+    os << "grow_by(2, 7) starts at " << index << ": " << vec[103] << " " << vec[104] << endl;
+
+    os << "\n3. iterators and the boundary check" << endl;
+    long long sum = 0;
+    for (int elem : vec) {
+        sum += elem;
+    }
+    os << "sum: " << sum << ", distance: " << (vec.end() - vec.begin()) << endl;
+    try {
+        vec.at(105);
+    } catch (std::out_of_range& e) {
+        os << "at(105): " << e.what() << endl;
+    }
+
+    os << "\n4. strings and clear" << endl;
+    concurrent_vector<std::string> strs;
+    strs.emplace_back(3, 'a');
+    strs.push_back("bcd");
+    print(os, strs);
+    strs.clear();
+    os << "size after clear: " << strs.size() << ", empty: " << strs.empty() << endl;
+    strs.push_back("again");
+    print(os, strs);
+}
+
+void test_concurrent_push(ostream& os) {
+    const int writers = 4;
+    const int per_writer = 50000;
+
+    os << "1. " << writers << " writers push " << per_writer << " numbers each while a reader scans" << endl;
+    concurrent_vector<long long> vec;
+    std::atomic<bool> done(false);
+    std::atomic<bool> consistent(true);
+
+    // every published element is a value pushed by a writer, never a slot still being constructed
+    std::thread reader([&]() {
+        while (!done.load()) {
+            size_t n = vec.size();
+            for (size_t i = 0; i < n; ++i) {
+                if (vec[i] < 0 || vec[i] >= writers * per_writer) {
+                    consistent = false;
+                }
+            }
+        }
+    });
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < writers; ++w) {
+        threads.emplace_back([&vec, w]() {
+            for (int i = 0; i < per_writer; ++i) {
+                if (i % 1000 == 0) {
+                    vec.grow_by(1, (long long)w * per_writer + i);
+                } else {
+                    vec.push_back((long long)w * per_writer + i);
+                }
+            }
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    done = true;
+    reader.join();
+
+    long long sum = 0;
+    std::vector<bool> seen(writers * per_writer, false);
+    for (long long elem : vec) {
+        sum += elem;
+        seen[elem] = true;
+    }
+    bool all = true;
+    for (bool s : seen) {
+        all = all && s;
+    }
+    long long n = writers * per_writer;
+    os << "size: " << vec.size() << endl;
+    os << "sum matches: " << (sum == n * (n - 1) / 2 ? "yes" : "no") << endl;
+    os << "every number is present: " << (all ? "yes" : "no") << endl;
+    os << "the reader only saw constructed elements: " << (consistent ? "yes" : "no") << endl;
+
+    os << "\n2. the addresses stay the same while the vector grows" << endl;
+    long long* p = &vec[12345];
+    long long value = *p;
+    vec.grow_by(1000000);
+    os << "same address: " << (p == &vec[12345] ? "yes" : "no") << ", same value: " << (*p == value ? "yes" : "no")
+       << endl;
+
+    os << "\n3. a writer stalled in its insertion doesn't hold the others back" << endl;
+    concurrent_vector<gated> gates;
+    std::thread stalled([&gates]() {
+        gates.grow_by(1, gated(-1, true));
+    });
+    while (!gated::entered.load()) {
+        std::this_thread::yield();
+    }
+    for (int i = 0; i < 1000; ++i) {
+        gates.push_back(gated(i, false));
+    }
+    os << "after 1000 push_back behind the stalled slot, size: " << gates.size() << endl;
+    gated::open = true;
+    stalled.join();
+    os << "after the stalled writer finishes, size: " << gates.size() << ", front: " << gates.front().value
+       << ", back: " << gates.back().value << endl;
+}
+
+int main() {
+    ofstream ofs1("concurrent_vector_test_single_thread.txt");
+    test_single_thread(ofs1);
+
+    ofstream ofs2("concurrent_vector_test_concurrent_push.txt");
+    test_concurrent_push(ofs2);
+
+    return 0;
+}
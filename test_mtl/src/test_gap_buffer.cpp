@@ -0,0 +1,149 @@
+#include <test_mtl/test_gap_buffer.h>
+#include <test_mtl/myutils.h>
+#include <mtl/algorithms.h>
+#include <fstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using std::ostream;
+using std::ofstream;
+using mtl::gap_buffer;
+using std::endl;
+
+// the characters as a string
+template <typename Buffer>
+std::string text(const Buffer& buf) {
+    std::string s;
+    for (char c : buf) {
+        s += c;
+    }
+    return s;
+}
+
+void test_editing(ostream& os) {
+    os << "1. type a line" << endl;
+    gap_buffer<char> buf;
+    for (char c : std::string("hello world")) {
+        buf.insert(c);
+    }
+    os << text(buf) << ", cursor: " << buf.cursor() << ", size: " << buf.size() << endl;
+
+    os << "\n2. move the cursor and type in the middle" << endl;
+    buf.move_cursor(5);
+    for (char c : std::string(",")) {
+        buf.insert(c);
+    }
+    buf.move_cursor(0);
+    buf.insert('>');
+    os << text(buf) << ", cursor: " << buf.cursor() << endl;
+
+    os << "\n3. backspace and delete" << endl;
+    buf.move_cursor(7);
+    buf.erase_before(1);
+    buf.erase_after(5);
+    for (char c : std::string("there")) {
+        buf.insert(c);
+    }
+    os << text(buf) << ", cursor: " << buf.cursor() << endl;
+    try {
+        buf.erase_after(2);
+    } catch (std::out_of_range& e) {
+        os << "erase_after(2) before the last element: " << e.what() << endl;
+    }
+    try {
+        buf.move_cursor(100);
+    } catch (std::out_of_range& e) {
+        os << "move_cursor(100): " << e.what() << endl;
+    }
+
+    os << "\n4. random access and the iterators skip the gap" << endl;
+    buf.move_cursor(3);
+    os << "buf[2]: " << buf[2] << ", buf[3]: " << buf[3] << ", at(8): " << buf.at(8) << ", back: " << buf.back()
+       << ", end - begin: " << (buf.end() - buf.begin()) << endl;
+    mtl::inplace_quicksort(buf.begin(), buf.end());
+    os << "sorted: " << text(buf) << endl;
+
+    os << "\n5. 100000 insertions around a moving cursor" << endl;
+    gap_buffer<int> nums;
+    for (int i = 0; i < 100000; ++i) {
+        if (i % 1000 == 0) {
+            nums.move_cursor(nums.size() / 2);
+        }
+        nums.insert(i);
+    }
+    long long sum = 0;
+    for (int x : nums) {
+        sum += x;
+    }
+    os << "size: " << nums.size() << ", sum: " << sum << ", capacity: " << nums.capacity() << endl;
+}
+
+void test_copy_move(ostream& os) {
+    os << "1. strings with the cursor in the middle" << endl;
+    gap_buffer<std::string> words{"one", "two", "four"};
+    words.move_cursor(2);
+    words.insert("three");
+    words.push_back("five");
+    words.move_cursor(1);
+    print(os, words);
+
+    os << "\n2. copy keeps the cursor" << endl;
+    gap_buffer<std::string> copied(words);
+    copied.insert("one and a half");
+    print(os, copied);
+    os << "cursor of the copy: " << copied.cursor() << endl;
+
+    os << "\n3. move and assignment" << endl;
+    gap_buffer<std::string> moved(std::move(words));
+    print(os, moved);
+    os << "the moved-from buffer is empty: " << words.empty() << endl;
+    words = copied;
+    words.erase(0);
+    print(os, words);
+    moved = std::move(copied);
+    print(os, moved);
+    moved.clear();
+    os << "size after clear: " << moved.size() << ", cursor: " << moved.cursor() << endl;
+
+    os << "\n4. a copy has a full array, moving its cursor mustn't move the elements" << endl;
+    gap_buffer<std::string> lines;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 300; ++i) {
+        std::string line = "a line long enough to be kept out of the string " + std::to_string(i);
+        lines.push_back(line);
+        expected.push_back(line);
+    }
+    lines.move_cursor(10);
+    gap_buffer<std::string> full(lines);
+    full.move_cursor(250);
+    full.move_cursor(3);
+    full.erase(200);
+    expected.erase(expected.begin() + 200);
+    bool same = full.size() == expected.size();
+    for (size_t i = 0; same && i < expected.size(); ++i) {
+        same = full[i] == expected[i];
+    }
+    os << "size: " << full.size() << ", cursor: " << full.cursor() << ", same as std::vector: " << same << endl;
+
+    os << "\n5. move between the allocators of different pools, the elements get a new array" << endl;
+    typedef gap_buffer<std::string, pool_allocator<std::string>> pool_gap_buffer;
+    pool_gap_buffer pooled1({"x", "yy", "zzz"}, pool_allocator<std::string>(1));
+    pooled1.move_cursor(1);
+    pool_gap_buffer pooled2(pool_allocator<std::string>(2));
+    pooled2 = std::move(pooled1);
+    print(os, pooled2);
+    os << "cursor: " << pooled2.cursor() << ", the moved one is empty: " << pooled1.empty()
+       << ", noexcept: " << std::is_nothrow_move_assignable<pool_gap_buffer>::value
+       << ", with std::allocator: " << std::is_nothrow_move_assignable<gap_buffer<std::string>>::value << endl;
+}
+
+int main() {
+    ofstream ofs1("gap_buffer_test_editing.txt");
+    test_editing(ofs1);
+
+    ofstream ofs2("gap_buffer_test_copy_move.txt");
+    test_copy_move(ofs2);
+
+    return 0;
+}
@@ -2,6 +2,8 @@
 #include <mtl/list.h>
 #include <test_mtl/myutils.h>
 #include <fstream>
+#include <string>
+#include <type_traits>
 
 using std::ostream;
 using std::ofstream;
@@ -118,6 +120,61 @@ void test_insert_remove(ostream& os) {
     os << "the returned iterator points to: " << *itr << endl;
 }
 
+void test_allocator(ostream& os) {
+    typedef list<int, counting_allocator<int>> counted_list;
+
+    os << "1. an empty list (only the sentinels)" << endl;
+    {
+        counted_list ls;
+        print(os, ls);
+        print_allocation_stats(os);
+
+        os << "\n2. after pushing back 100 numbers" << endl;
+        for (int i = 0; i < 100; ++i) {
+            ls.push_back(i);
+        }
+        print(os, ls);
+        print_allocation_stats(os);
+
+        os << "\n3. after removing range [10, 60)" << endl;
+        ls.remove(ls.begin() + 10, ls.begin() + 60);
+        print(os, ls);
+        print_allocation_stats(os);
+
+        os << "\n4. copy it" << endl;
+        counted_list ls1(ls);
+        print(os, ls1);
+        print_allocation_stats(os);
+    }
+
+    os << "\n5. after all the lists are destroyed" << endl;
+    print_allocation_stats(os);
+
+    os << "\n6. a move assignment takes over the nodes and allocates nothing" << endl;
+    {
+        counted_list ls2({1, 2, 3});
+        counted_list ls3({4, 5});
+        size_t before = allocation_stats::allocations;
+        ls3 = std::move(ls2);
+        print(os, ls3);
+        os << "the moved one is empty: " << ls2.empty() << ", allocations: " << allocation_stats::allocations - before
+           << endl;
+        ls2.push_back(6);
+        print(os, ls2);
+    }
+    print_allocation_stats(os);
+
+    os << "\n7. move between the allocators of different pools, it may allocate so it isn't noexcept" << endl;
+    typedef list<std::string, pool_allocator<std::string>> pool_list;
+    pool_list pooled1({"x", "yy", "zzz"}, pool_allocator<std::string>(1));
+    pool_list pooled2(pool_allocator<std::string>(2));
+    pooled2 = std::move(pooled1);
+    print(os, pooled2);
+    os << "the moved one is empty: " << pooled1.empty()
+       << ", noexcept: " << std::is_nothrow_move_assignable<pool_list>::value
+       << ", with counting_allocator: " << std::is_nothrow_move_assignable<counted_list>::value << endl;
+}
+
 int main() {
     ofstream ofs1("list_test_constructor.txt");
     if (ofs1.is_open())
@@ -134,4 +191,8 @@ int main() {
     ofstream ofs4("list_test_insert_remove.txt");
     if (ofs4.is_open())
         test_insert_remove(ofs4);
+
+    ofstream ofs5("list_test_allocator.txt");
+    if (ofs5.is_open())
+        test_allocator(ofs5);
 }
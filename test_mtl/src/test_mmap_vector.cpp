@@ -0,0 +1,87 @@
+#include <test_mtl/test_mmap_vector.h>
+#include <mtl/algorithms.h>
+#include <fstream>
+#include <cstdio>
+
+using std::ostream;
+using std::ofstream;
+using mtl::mmap_vector;
+using std::endl;
+
+// the file backing the vectors, it's removed after the tests
+static const char* const data_file = "mmap_vector_test.bin";
+
+template <typename T, typename Growth>
+void print_mmap_vector(ostream& os, const mmap_vector<T, Growth>& vec) {
+    os << "size: " << vec.size() << "  capacity: " << vec.capacity() << endl;
+    for (auto itr = vec.begin(); itr != vec.end(); ++itr) {
+        os << *itr << " ";
+    }
+    os << endl;
+}
+
+void test_persistence(ostream& os) {
+    {
+        mmap_vector<int> vec(data_file, true);
+        os << "1. an empty mmap_vector" << endl;
+        print_mmap_vector(os, vec);
+
+        for (int i = 0; i < 200; ++i) {
+            vec.push_back(i);
+        }
+        os << "\n2. after pushing back 200 numbers" << endl;
+        print_mmap_vector(os, vec);
+
+        for (int i = 0; i < 150; ++i) {
+            vec.pop_back();
+        }
+        vec.sync();
+        os << "\n3. after popping back 150 numbers and syncing" << endl;
+        print_mmap_vector(os, vec);
+    }
+
+    mmap_vector<int> vec(data_file);
+    os << "\n4. reopen the file" << endl;
+    print_mmap_vector(os, vec);
+
+    vec.push_back(vec.back());
+    vec.shrink();
+    os << "\n5. push back the last one and shrink" << endl;
+    print_mmap_vector(os, vec);
+
+    try {
+        vec.at(vec.size());
+    } catch (std::out_of_range& e) {
+        os << "\n6. at(size()): " << e.what() << endl;
+    }
+}
+
+void test_algorithms(ostream& os) {
+    mmap_vector<int> vec(data_file, true);
+    vec.advise(mmap_vector<int>::access::random);
+    for (int i = 0; i < 50; ++i) {
+        vec.push_back((i * 37) % 50);
+    }
+    os << "1. 50 numbers in a shuffled order" << endl;
+    print_mmap_vector(os, vec);
+
+    mtl::inplace_quicksort(vec.begin(), vec.end());
+    os << "\n2. after quicksort" << endl;
+    print_mmap_vector(os, vec);
+
+    vec.advise(mmap_vector<int>::access::willneed, 10, 20);
+    vec.clear();
+    os << "\n3. after clearing" << endl;
+    print_mmap_vector(os, vec);
+}
+
+int main() {
+    ofstream ofs1("mmap_vector_test_persistence.txt");
+    test_persistence(ofs1);
+
+    ofstream ofs2("mmap_vector_test_algorithms.txt");
+    test_algorithms(ofs2);
+
+    std::remove(data_file);
+    return 0;
+}
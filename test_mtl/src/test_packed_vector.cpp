@@ -0,0 +1,142 @@
+#include <test_mtl/test_packed_vector.h>
+#include <test_mtl/myutils.h>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+using std::ostream;
+using std::ofstream;
+using mtl::packed_vector;
+using mtl::delta_vector;
+using std::endl;
+
+void test_packed(ostream& os) {
+    os << "1. push back 20 values of 5 bits" << endl;
+    packed_vector<5> small;
+    for (std::uint64_t i = 0; i < 20; ++i) {
+        small.push_back(i * 3 % 32);
+    }
+    print(os, small);
+    small.set(0, 31);
+    small.pop_back();
+    os << "after set(0, 31) and pop_back: " << small.at(0) << " " << small.size() << endl;
+    try {
+        small.push_back(32);
+    } catch (std::out_of_range& e) {
+        os << "push_back(32): " << e.what() << endl;
+    }
+
+    os << "\n2. pack 10000 12-bit values from a vector and back" << endl;
+    mtl::vector<std::uint32_t> values;
+    for (std::uint32_t i = 0; i < 10000; ++i) {
+        values.push_back(i * 2654435761u % 4096);
+    }
+    packed_vector<12, std::uint32_t> packed(values.view());
+    mtl::vector<std::uint32_t> unpacked = packed.to_vector();
+    bool same = unpacked.size() == values.size();
+    for (size_t i = 0; same && i < values.size(); ++i) {
+        same = unpacked[i] == values[i] && packed[i] == values[i];
+    }
+    os << "the same values: " << (same ? "yes" : "no") << ", bytes: " << packed.memory() << " instead of "
+       << values.size() * sizeof(std::uint32_t) << endl;
+
+    os << "\n3. unpack a range of 4-bit values through whole words" << endl;
+    packed_vector<4, std::uint8_t> nibbles(100, 7);
+    for (size_t i = 0; i < 100; i += 3) {
+        nibbles.set(i, 15);
+    }
+    std::uint8_t out[50];
+    nibbles.unpack(5, 50, out);
+    bool unpack_ok = true;
+    for (size_t i = 0; i < 50; ++i) {
+        unpack_ok = unpack_ok && out[i] == nibbles[i + 5];
+    }
+    os << "unpack ok: " << (unpack_ok ? "yes" : "no") << ", out[0..3]: " << int(out[0]) << " " << int(out[1]) << " "
+       << int(out[2]) << endl;
+    try {
+        nibbles.unpack(90, 11, out);
+    } catch (std::out_of_range& e) {
+        os << "unpack(90, 11): " << e.what() << endl;
+    }
+
+    os << "\n4. unpack ranges of values crossing the words through whole cycles" << endl;
+    packed_vector<12, std::uint16_t> twelve;
+    packed_vector<13, std::uint16_t> thirteen;
+    for (size_t i = 0; i < 1000; ++i) {
+        twelve.push_back(static_cast<std::uint16_t>(i * 2654435761u % 4096));
+        thirteen.push_back(static_cast<std::uint16_t>(i * 2654435761u % 8192));
+    }
+    std::uint16_t cycle_out[1000];
+    bool cycles_ok = true;
+    for (size_t first : {size_t(0), size_t(3), size_t(17), size_t(100)}) {
+        twelve.unpack(first, 1000 - first, cycle_out);
+        for (size_t i = 0; first + i < 1000; ++i) {
+            cycles_ok = cycles_ok && cycle_out[i] == twelve[first + i];
+        }
+        thirteen.unpack(first, 1000 - first, cycle_out);
+        for (size_t i = 0; first + i < 1000; ++i) {
+            cycles_ok = cycles_ok && cycle_out[i] == thirteen[first + i];
+        }
+    }
+    os << "12-bit and 13-bit unpack ok: " << (cycles_ok ? "yes" : "no") << endl;
+
+    os << "\n5. 64-bit values" << endl;
+    packed_vector<64> full;
+    full.push_back(~std::uint64_t(0));
+    full.push_back(1);
+    os << full[0] << " " << full[1] << endl;
+}
+
+void test_delta(ostream& os) {
+    os << "1. encode sorted ids" << endl;
+    mtl::vector<std::uint64_t> ids;
+    std::uint64_t id = 1000000;
+    for (int i = 0; i < 10000; ++i) {
+        id += 1 + (i * 7) % 50;
+        ids.push_back(id);
+    }
+    delta_vector<> deltas(ids.view());
+    mtl::vector<std::uint64_t> decoded = deltas.to_vector();
+    bool same = decoded.size() == ids.size();
+    for (size_t i = 0; same && i < ids.size(); ++i) {
+        same = decoded[i] == ids[i];
+    }
+    size_t i = 0;
+    for (auto itr = deltas.begin(); same && itr != deltas.end(); ++itr, ++i) {
+        same = *itr == ids[i];
+    }
+    os << "the same values: " << (same ? "yes" : "no") << ", bytes: " << deltas.memory() << " instead of "
+       << ids.size() * sizeof(std::uint64_t) << endl;
+    os << "deltas[0]: " << deltas[0] << ", deltas[5000]: " << deltas.at(5000) << ", back: " << deltas.back() << endl;
+
+    os << "\n2. search through the skip pointers" << endl;
+    size_t found = deltas.lower_bound(ids[7777]);
+    size_t between = deltas.lower_bound(ids[1280] + 1);
+    os << "lower_bound(ids[7777]): " << found << ", lower_bound(ids[1280] + 1): " << between << endl;
+    os << "lower_bound(0): " << deltas.lower_bound(0) << ", lower_bound(max): " << deltas.lower_bound(~std::uint64_t(0))
+       << endl;
+    os << "contains ids[3]: " << deltas.contains(ids[3]) << ", contains ids[3] + 1: " << deltas.contains(ids[3] + 1)
+       << endl;
+
+    os << "\n3. decreasing values are rejected" << endl;
+    delta_vector<std::uint32_t> small;
+    small.push_back(5);
+    small.push_back(5);
+    small.push_back(300);
+    try {
+        small.push_back(4);
+    } catch (std::invalid_argument& e) {
+        os << "push_back(4): " << e.what() << endl;
+    }
+    print(os, small);
+}
+
+int main() {
+    ofstream ofs1("packed_vector_test_packed.txt");
+    test_packed(ofs1);
+
+    ofstream ofs2("packed_vector_test_delta.txt");
+    test_delta(ofs2);
+
+    return 0;
+}
@@ -0,0 +1,135 @@
+#include <test_mtl/test_persistent_vector.h>
+#include <test_mtl/myutils.h>
+#include <fstream>
+
+using std::ostream;
+using std::ofstream;
+using mtl::persistent_vector;
+using mtl::transient_vector;
+using std::endl;
+
+typedef persistent_vector<int, counting_allocator<int>> counted_persistent_vector;
+
+// the sum of the elements, which walks through all the leaves
+template <typename Vector>
+long long sum(const Vector& vec) {
+    long long s = 0;
+    for (auto itr = vec.begin(); itr != vec.end(); ++itr) {
+        s += *itr;
+    }
+    return s;
+}
+
+void test_versions(ostream& os) {
+    os << "1. push back 5 versions" << endl;
+    persistent_vector<int> v0;
+    persistent_vector<int> v1 = v0.push_back(1);
+    persistent_vector<int> v2 = v1.push_back(2);
+    persistent_vector<int> v3 = v2.push_back(3);
+    persistent_vector<int> v4 = v3.set(0, 10);
+    persistent_vector<int> v5 = v4.pop_back();
+    print(os, v0);
+    print(os, v1);
+    print(os, v2);
+    print(os, v3);
+    print(os, v4);
+    print(os, v5);
+
+    os << "\n2. the boundary checks" << endl;
+    try {
+        v3.at(3);
+    } catch (std::out_of_range& e) {
+        os << "at(3): " << e.what() << endl;
+    }
+    try {
+        v0.pop_back();
+    } catch (std::out_of_range& e) {
+        os << "pop_back on empty: " << e.what() << endl;
+    }
+
+    os << "\n3. a snapshot of 100000 numbers and a version with one element changed" << endl;
+    counted_persistent_vector big;
+    for (int i = 0; i < 100000; ++i) {
+        big = big.push_back(i);
+    }
+    counted_persistent_vector snapshot = big;
+    std::size_t before = allocation_stats::allocations;
+    counted_persistent_vector changed = big.set(50000, -1);
+    os << "snapshot sum: " << sum(snapshot) << ", changed sum: " << sum(changed) << endl;
+    os << "nodes copied for the new version: " << allocation_stats::allocations - before << endl;
+}
+
+void test_concat_slice(ostream& os) {
+    persistent_vector<int> vec;
+    for (int i = 0; i < 1000; ++i) {
+        vec = vec.push_back(i);
+    }
+
+    os << "1. slice [10, 20) and [990, 1000)" << endl;
+    persistent_vector<int> head = vec.slice(10, 20);
+    persistent_vector<int> tail = vec.slice(990, 1000);
+    print(os, head);
+    print(os, tail);
+
+    os << "\n2. concat them and push back one more" << endl;
+    persistent_vector<int> joined = head.concat(tail).push_back(-1);
+    print(os, joined);
+
+    os << "\n3. rotate 1000 numbers 100 times by slicing and concatenating" << endl;
+    persistent_vector<int> rotated = vec;
+    for (int k = 0; k < 100; ++k) {
+        size_t mid = (k * 37) % rotated.size();
+        rotated = rotated.slice(mid, rotated.size()).concat(rotated.slice(0, mid));
+    }
+    size_t offset = 0;
+    while (rotated[offset] != 0) {
+        ++offset;
+    }
+    bool in_order = true;
+    for (size_t i = 0; i < rotated.size(); ++i) {
+        in_order = in_order && rotated[(offset + i) % rotated.size()] == static_cast<int>(i);
+    }
+    os << "size: " << rotated.size() << ", still a rotation: " << in_order << ", sum: " << sum(rotated) << endl;
+
+    os << "\n4. an invalid slice" << endl;
+    try {
+        vec.slice(20, 10);
+    } catch (std::out_of_range& e) {
+        os << e.what() << endl;
+    }
+}
+
+void test_transient(ostream& os) {
+    os << "1. load 100000 numbers by a transient" << endl;
+    transient_vector<int> t;
+    for (int i = 0; i < 100000; ++i) {
+        t.push_back(i);
+    }
+    persistent_vector<int> loaded = t.persistent();
+    os << "size: " << loaded.size() << ", sum: " << sum(loaded) << endl;
+
+    os << "\n2. keep modifying the transient, the version taken is unchanged" << endl;
+    t.set(0, 100);
+    t.pop_back();
+    t.push_back(7);
+    os << "transient: size " << t.size() << ", first " << t[0] << ", last " << t[t.size() - 1] << endl;
+    os << "version: size " << loaded.size() << ", first " << loaded[0] << ", last " << loaded.back() << endl;
+
+    os << "\n3. a transient from a version" << endl;
+    transient_vector<int> t2 = loaded.slice(0, 3).transient();
+    t2.emplace_back(3);
+    print(os, t2.persistent());
+}
+
+int main() {
+    ofstream ofs1("persistent_vector_test_versions.txt");
+    test_versions(ofs1);
+
+    ofstream ofs2("persistent_vector_test_concat_slice.txt");
+    test_concat_slice(ofs2);
+
+    ofstream ofs3("persistent_vector_test_transient.txt");
+    test_transient(ofs3);
+
+    return 0;
+}
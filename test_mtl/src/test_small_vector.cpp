@@ -0,0 +1,188 @@
+#include <test_mtl/test_small_vector.h>
+#include <test_mtl/myutils.h>
+#include <mtl/stack.h>
+#include <mtl/priority_queue.h>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+using std::ostream;
+using std::ofstream;
+using mtl::small_vector;
+using mtl::static_vector;
+using std::endl;
+
+typedef small_vector<int, 8, counting_allocator<int>> counted_small_vector;
+
+// its copies throw from a negative value, it counts the objects alive
+struct throwing_copy {
+    static inline int alive = 0;
+
+    int value;
+
+    throwing_copy(int v) : value(v) {
+        ++alive;
+    }
+
+    throwing_copy(const throwing_copy& t) : value(t.value) {
+        if (value < 0) {
+            throw std::runtime_error("negative");
+        }
+        ++alive;
+    }
+
+    ~throwing_copy() {
+        --alive;
+    }
+};
+
+void test_inline_spill(ostream& os) {
+    counted_small_vector vec;
+    os << "1. an empty small_vector<int, 8>" << endl;
+    print_vector(os, vec);
+    os << "inline: " << vec.is_inline() << endl;
+    print_allocation_stats(os);
+
+    for (int i = 0; i < 8; ++i) {
+        vec.push_back(i);
+    }
+    os << "\n2. after pushing back 8 numbers" << endl;
+    print_vector(os, vec);
+    os << "inline: " << vec.is_inline() << endl;
+    print_allocation_stats(os);
+
+    for (int i = 8; i < 20; ++i) {
+        vec.push_back(i);
+    }
+    os << "\n3. after pushing back 20 numbers" << endl;
+    print_vector(os, vec);
+    os << "inline: " << vec.is_inline() << endl;
+    print_allocation_stats(os);
+
+    vec.remove(vec.begin() + 4, vec.end());
+    vec.shrink();
+    os << "\n4. after removing range [4, 20) and shrinking" << endl;
+    print_vector(os, vec);
+    os << "inline: " << vec.is_inline() << endl;
+    print_allocation_stats(os);
+}
+
+void test_copy_move(ostream& os) {
+    counted_small_vector vec1({1, 2, 3});
+    counted_small_vector vec2;
+    for (int i = 0; i < 100; ++i) {
+        vec2.push_back(i);
+    }
+
+    os << "1. copy an inline one and a spilled one" << endl;
+    counted_small_vector vec3(vec1);
+    counted_small_vector vec4(vec2);
+    print_vector(os, vec3);
+    os << "inline: " << vec3.is_inline() << endl;
+    print_vector(os, vec4);
+    os << "inline: " << vec4.is_inline() << endl;
+    print_allocation_stats(os);
+
+    os << "\n2. move them, the spilled array is taken over" << endl;
+    counted_small_vector vec5(std::move(vec3));
+    counted_small_vector vec6(std::move(vec4));
+    print_vector(os, vec5);
+    print_vector(os, vec6);
+    os << "the moved ones: " << vec3.size() << ", " << vec4.size() << endl;
+    print_allocation_stats(os);
+
+    os << "\n3. assign the inline one to the spilled one" << endl;
+    vec6 = vec5;
+    print_vector(os, vec6);
+    os << "inline: " << vec6.is_inline() << endl;
+    print_allocation_stats(os);
+
+    os << "\n4. the moves are noexcept only when moving the elements one by one can't throw" << endl;
+    struct throwing_move {
+        throwing_move() = default;
+        throwing_move(throwing_move&&) {}
+    };
+    os << "small_vector<int>: " << std::is_nothrow_move_constructible<counted_small_vector>::value << ", "
+       << std::is_nothrow_move_assignable<counted_small_vector>::value << endl;
+    os << "static_vector<int>: " << std::is_nothrow_move_constructible<static_vector<int, 4>>::value << ", "
+       << std::is_nothrow_move_assignable<static_vector<int, 4>>::value << endl;
+    os << "small_vector with a throwing move: "
+       << std::is_nothrow_move_constructible<small_vector<throwing_move, 4>>::value << ", "
+       << std::is_nothrow_move_assignable<small_vector<throwing_move, 4>>::value << endl;
+
+    os << "\n5. a constructor throwing while the elements are inline destroys them and leaves the local array" << endl;
+    try {
+        small_vector<throwing_copy, 8> throwing1({1, 2, -3});
+    } catch (const std::exception& exc) {
+        os << "the initializer list: " << exc.what() << ", alive: " << throwing_copy::alive << endl;
+    }
+    {
+        small_vector<throwing_copy, 8> throwing2;
+        throwing2.emplace_back(1);
+        throwing2.emplace_back(-2);
+        try {
+            small_vector<throwing_copy, 8> throwing3(throwing2);
+        } catch (const std::exception& exc) {
+            os << "the copy constructor: " << exc.what() << ", alive: " << throwing_copy::alive << endl;
+        }
+    }
+
+    os << "\n6. a vector moved from an inline small_vector allocates, so only the move from a vector is noexcept"
+       << endl;
+    mtl::vector<int, counting_allocator<int>> moved_out(std::move(vec5));
+    print_vector(os, moved_out);
+    os << "the small_vector is empty: " << vec5.empty() << endl;
+    print_allocation_stats(os);
+    os << "from a vector: "
+       << std::is_nothrow_constructible<mtl::vector<int>, mtl::vector<int>&&>::value << ", from a small_vector: "
+       << std::is_nothrow_constructible<mtl::vector<int>, small_vector<int, 4>&&>::value << ", assigned: "
+       << std::is_nothrow_assignable<mtl::vector<int>&, small_vector<int, 4>&&>::value << endl;
+    moved_out = counted_small_vector({7, 8, 9});
+    print_vector(os, moved_out);
+}
+
+void test_static_vector(ostream& os) {
+    static_vector<int, 10> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    os << "1. a full static_vector<int, 10>" << endl;
+    print_vector(os, vec);
+
+    os << "\n2. push back one more" << endl;
+    try {
+        vec.push_back(10);
+    } catch (const std::exception& exc) {
+        os << "when a full static_vector trying to push back: " << exc.what() << endl;
+    }
+    os << "try_push_back returns: " << vec.try_push_back(10) << endl;
+    print_vector(os, vec);
+
+    os << "\n3. a bounded stack and a bounded priority_queue" << endl;
+    mtl::stack<int, static_vector<int, 4>> st;
+    mtl::priority_queue<int, static_vector<int, 4>> pq;
+    for (int i = 4; i > 0; --i) {
+        st.push(i);
+        pq.push(i);
+    }
+    os << "the top of the stack: " << st.top() << ", the top of the priority_queue: " << pq.top() << endl;
+    try {
+        pq.push(0);
+    } catch (const std::exception& exc) {
+        os << "when a full priority_queue trying to push: " << exc.what() << endl;
+    }
+    os << "the size of the priority_queue: " << pq.size() << endl;
+}
+
+int main() {
+    ofstream ofs1("small_vector_test_inline_spill.txt");
+    test_inline_spill(ofs1);
+
+    ofstream ofs2("small_vector_test_copy_move.txt");
+    test_copy_move(ofs2);
+
+    ofstream ofs3("static_vector_test.txt");
+    test_static_vector(ofs3);
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include <test_mtl/test_soa_vector.h>
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+
+using std::ostream;
+using std::ofstream;
+using mtl::soa_vector;
+using std::endl;
+
+// x, y, mass and name of a particle
+typedef soa_vector<float, float, double, std::string> particles;
+
+void print_particles(ostream& os, const particles& ps) {
+    os << "The size: " << ps.size() << endl;
+    for (auto row : ps) {
+        os << "(" << std::get<0>(row) << ", " << std::get<1>(row) << ", " << std::get<2>(row) << ", "
+           << std::get<3>(row) << ") ";
+    }
+    os << endl;
+}
+
+// throws when it's copied from a negative number
+struct picky {
+    int value;
+
+    picky(int v) : value(v) {
+        if (v < 0) {
+            throw std::invalid_argument("negative");
+        }
+    }
+};
+
+void test_rows(ostream& os) {
+    os << "1. push back tuples and emplace back fields" << endl;
+    particles ps;
+    ps.push_back(std::make_tuple(1.0f, 2.0f, 3.0, std::string("a")));
+    std::tuple<float, float, double, std::string> t(4.0f, 5.0f, 6.0, "b");
+    ps.push_back(t);
+    ps.emplace_back(7.0f, 8.0f, 9.0, "c");
+    print_particles(os, ps);
+
+    os << "\n2. modify through the rows" << endl;
+    std::get<3>(ps[0]) = "aa";
+    for (auto row : ps) {
+        std::get<2>(row) *= 10;
+    }
+    ps.at(2) = std::make_tuple(0.5f, 0.5f, 0.5, std::string("z"));
+    print_particles(os, ps);
+    try {
+        ps.at(3);
+    } catch (std::out_of_range& e) {
+        os << "at(3): " << e.what() << endl;
+    }
+
+    os << "\n3. pop back and clear" << endl;
+    ps.pop_back();
+    print_particles(os, ps);
+    ps.clear();
+    print_particles(os, ps);
+
+    os << "\n4. a throwing field leaves all the columns at the same size" << endl;
+    soa_vector<int, picky> pv;
+    pv.emplace_back(1, 1);
+    try {
+        pv.emplace_back(2, -1);
+    } catch (std::invalid_argument& e) {
+        os << "caught: " << e.what() << endl;
+    }
+    os << "size: " << pv.size() << ", column 0: " << pv.column<0>().size() << ", column 1: "
+       << pv.column<1>().size() << endl;
+
+    os << "\n5. the standard algorithms through the rows" << endl;
+    soa_vector<int, std::string> records;
+    for (int i = 0; i < 50; ++i) {
+        records.emplace_back((i * 37) % 50, std::to_string((i * 37) % 50));
+    }
+    std::reverse(records.begin(), records.end());
+    os << "reversed, the first row: " << std::get<0>(records[0]) << ":" << std::get<1>(records[0]) << endl;
+    std::sort(records.begin(), records.end());
+    bool kept = true;
+    for (int i = 0; i < 50; ++i) {
+        kept = kept && std::get<0>(records[i]) == i && std::get<1>(records[i]) == std::to_string(i);
+    }
+    os << "sorted: " << std::is_sorted(records.begin(), records.end()) << ", rows kept together: " << kept << endl;
+    std::tuple<int, std::string> record = records[7];
+    swap(records[0], records[1]);
+    os << "a row converts to the record: " << std::get<1>(record) << ", swapped rows: " << std::get<0>(records[0])
+       << " " << std::get<0>(records[1]) << endl;
+    os << "the pointer of the iterator is void: "
+       << std::is_void<std::iterator_traits<soa_vector<int, std::string>::iterator>::pointer>::value << endl;
+}
+
+void test_columns(ostream& os) {
+    os << "1. scan one column" << endl;
+    particles ps;
+    ps.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        ps.emplace_back(float(i), float(-i), double(i % 7), std::to_string(i));
+    }
+    auto xs = ps.column<0>();
+    float sum = 0;
+    for (size_t i = 0; i < xs.size(); ++i) {
+        sum += xs[i];
+    }
+    os << "sum of x: " << sum << ", capacity: " << ps.capacity() << endl;
+
+    os << "\n2. scale a column through its span" << endl;
+    auto ys = ps.column<1>();
+    float* y = ys.data();
+    for (size_t i = 0; i < ys.size(); ++i) {
+        y[i] *= 2;
+    }
+    os << "y[10]: " << std::get<1>(ps[10]) << endl;
+
+    os << "\n3. sort by mass, the other columns follow" << endl;
+    soa_vector<double, int, std::string> small;
+    small.emplace_back(3.5, 1, "one");
+    small.emplace_back(1.5, 2, "two");
+    small.emplace_back(2.5, 3, "three");
+    small.emplace_back(0.5, 4, "four");
+    small.sort_by<0>();
+    for (auto row : small) {
+        os << std::get<0>(row) << ":" << std::get<1>(row) << ":" << std::get<2>(row) << " ";
+    }
+    os << endl;
+
+    os << "\n4. sort by name in descending order" << endl;
+    small.sort_by<2>(std::greater<std::string>());
+    for (auto row : small) {
+        os << std::get<0>(row) << ":" << std::get<1>(row) << ":" << std::get<2>(row) << " ";
+    }
+    os << endl;
+
+    os << "\n5. sort 1000 particles by mass and check the rows" << endl;
+    ps.sort_by<2>();
+    bool sorted = true;
+    bool rows_kept = true;
+    for (size_t i = 0; i < ps.size(); ++i) {
+        auto row = ps[i];
+        if (i > 0 && std::get<2>(ps[i - 1]) > std::get<2>(row)) {
+            sorted = false;
+        }
+        int id = std::stoi(std::get<3>(row));
+        if (std::get<0>(row) != float(id) || std::get<1>(row) != float(-2 * id) || std::get<2>(row) != id % 7) {
+            rows_kept = false;
+        }
+    }
+    os << "sorted: " << (sorted ? "yes" : "no") << ", rows kept together: " << (rows_kept ? "yes" : "no") << endl;
+}
+
+int main() {
+    ofstream ofs1("soa_vector_test_rows.txt");
+    test_rows(ofs1);
+
+    ofstream ofs2("soa_vector_test_columns.txt");
+    test_columns(ofs2);
+
+    return 0;
+}
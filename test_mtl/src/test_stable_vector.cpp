@@ -0,0 +1,100 @@
+#include <test_mtl/test_stable_vector.h>
+#include <test_mtl/myutils.h>
+#include <mtl/algorithms.h>
+#include <fstream>
+#include <string>
+#include <type_traits>
+
+using std::ostream;
+using std::ofstream;
+using mtl::stable_vector;
+using std::endl;
+
+void test_stable_addresses(ostream& os) {
+    os << "1. push back 10 numbers into chunks of 4" << endl;
+    stable_vector<int, 4> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    print(os, vec);
+    os << "capacity: " << vec.capacity() << ", front: " << vec.front() << ", back: " << vec.back() << endl;
+
+    os << "\n2. the addresses stay the same while 100000 more elements are pushed" << endl;
+    int* first = &vec[0];
+    int* ninth = &vec[9];
+    for (int i = 10; i < 100010; ++i) {
+        vec.push_back(i);
+    }
+    os << "size: " << vec.size() << endl;
+    os << "same addresses: " << (first == &vec[0] && ninth == &vec[9] ? "yes" : "no")
+       << ", values: " << *first << " " << *ninth << endl;
+
+    os << "\n3. pop back, clear and shrink_to_fit" << endl;
+    vec.pop_back();
+    os << "back after pop_back: " << vec.back() << endl;
+    vec.clear();
+    os << "after clear, size: " << vec.size() << ", capacity: " << vec.capacity() << endl;
+    vec.emplace_back(42);
+    vec.shrink_to_fit();
+    os << "after shrink_to_fit, size: " << vec.size() << ", capacity: " << vec.capacity() << endl;
+    try {
+        vec.at(1);
+    } catch (std::out_of_range& e) {
+        os << "at(1): " << e.what() << endl;
+    }
+
+    os << "\n4. copy and move strings" << endl;
+    stable_vector<std::string, 2> strs{"a", "bb", "ccc"};
+    std::string* addr = &strs[2];
+    stable_vector<std::string, 2> copied(strs);
+    stable_vector<std::string, 2> moved(std::move(strs));
+    print(os, copied);
+    print(os, moved);
+    os << "the moved vector keeps the chunks: " << (addr == &moved[2] ? "yes" : "no") << endl;
+    copied = moved;
+    copied.push_back("dddd");
+    print(os, copied);
+
+    os << "\n5. move between the allocators of different pools, the elements get new chunks" << endl;
+    typedef stable_vector<std::string, 2, pool_allocator<std::string>> pool_stable_vector;
+    pool_stable_vector pooled1({"x", "yy", "zzz"}, pool_allocator<std::string>(1));
+    pool_stable_vector pooled2(pool_allocator<std::string>(2));
+    pooled2 = std::move(pooled1);
+    print(os, pooled2);
+    os << "the moved one is empty: " << pooled1.empty()
+       << ", noexcept: " << std::is_nothrow_move_assignable<pool_stable_vector>::value
+       << ", with std::allocator: " << std::is_nothrow_move_assignable<stable_vector<std::string, 2>>::value << endl;
+}
+
+void test_algorithms(ostream& os) {
+    os << "1. quicksort and mergesort through the iterators" << endl;
+    stable_vector<int, 8> vec;
+    for (int i = 0; i < 30; ++i) {
+        vec.push_back((i * 17) % 30);
+    }
+    print(os, vec);
+    mtl::inplace_quicksort(vec.begin(), vec.end());
+    print(os, vec);
+
+    stable_vector<int, 8> vec2;
+    for (int i = 0; i < 30; ++i) {
+        vec2.push_back((i * 7) % 30);
+    }
+    mtl::inplace_mergesort(vec2.begin(), vec2.end());
+    print(os, vec2);
+
+    os << "\n2. count_length and a const iterator" << endl;
+    const stable_vector<int, 8>& cref = vec;
+    stable_vector<int, 8>::const_iterator itr = vec.begin();
+    os << "length: " << mtl::count_length(cref.begin(), cref.end()) << ", *(begin + 20): " << *(itr + 20) << endl;
+}
+
+int main() {
+    ofstream ofs1("stable_vector_test_stable_addresses.txt");
+    test_stable_addresses(ofs1);
+
+    ofstream ofs2("stable_vector_test_algorithms.txt");
+    test_algorithms(ofs2);
+
+    return 0;
+}
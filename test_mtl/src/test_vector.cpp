@@ -1,6 +1,16 @@
 #include <test_mtl/test_vector.h>
 #include <test_mtl/myutils.h>
+#include <mtl/stack.h>
+#include <mtl/priority_queue.h>
+#include <mtl/allocator.h>
+#include <mtl/list.h>
+#include <mtl/cow_vector.h>
+#include <cstdint>
 #include <iostream>
+#include <string>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
 #include <fstream>
 
 using std::ostream;
@@ -130,6 +140,395 @@ void test_insert_remove(ostream& os) {
     os << "the returned iterator points to: " << *itr << endl;
 }
 
+void test_allocator(ostream& os) {
+    typedef vector<int, counting_allocator<int>> counted_vector;
+
+    os << "1. an empty vector" << endl;
+    {
+        counted_vector vec;
+        print_vector(os, vec);
+        print_allocation_stats(os);
+
+        os << "\n2. after pushing back 200 numbers" << endl;
+        for (int i = 0; i < 200; ++i) {
+            vec.push_back(i);
+        }
+        print_vector(os, vec);
+        print_allocation_stats(os);
+
+        os << "\n3. copy it" << endl;
+        counted_vector vec1(vec);
+        print_vector(os, vec1);
+        print_allocation_stats(os);
+
+        os << "\n4. move it" << endl;
+        counted_vector vec2(std::move(vec1));
+        print_vector(os, vec2);
+        print_allocation_stats(os);
+
+        os << "\n5. a stack and a priority_queue based on it" << endl;
+        stack<int, counted_vector> st;
+        priority_queue<int, counted_vector> pq;
+        for (int i = 10; i > 0; --i) {
+            st.push(i);
+            pq.push(i);
+        }
+        os << "the top of the stack: " << st.top() << ", the top of the priority_queue: " << pq.top() << endl;
+        print_allocation_stats(os);
+        typedef vector<int, pool_allocator<int>> pool_vector;
+        os << "their moves are noexcept as the ones of the container: "
+           << std::is_nothrow_move_assignable<stack<int, counted_vector>>::value << ", "
+           << std::is_nothrow_move_assignable<priority_queue<int, counted_vector>>::value
+           << ", on the allocators of pools: " << std::is_nothrow_move_assignable<stack<int, pool_vector>>::value
+           << ", " << std::is_nothrow_move_assignable<priority_queue<int, pool_vector>>::value << endl;
+    }
+
+    os << "\n6. after all the containers are destroyed" << endl;
+    print_allocation_stats(os);
+}
+
+void test_growth(ostream& os) {
+    os << "1. the capacities of the vectors with different growth policies after pushing back 1000 numbers" << endl;
+    vector<int, std::allocator<int>, double_growth> vec1;
+    vector<int, std::allocator<int>, one_and_half_growth> vec2;
+    vector<int, std::allocator<int>, fixed_step_growth<300>> vec3;
+    vector<int, std::allocator<int>, capped_growth<double_growth, 256>> vec4;
+    for (int i = 0; i < 1000; ++i) {
+        vec1.push_back(i);
+        vec2.push_back(i);
+        vec3.push_back(i);
+        vec4.push_back(i);
+    }
+    os << "double: " << vec1.capacity() << ", 1.5x: " << vec2.capacity()
+       << ", step 300: " << vec3.capacity() << ", double capped by 256: " << vec4.capacity() << endl;
+
+    os << "\n2. clear with and without retaining the array" << endl;
+    vector<int, std::allocator<int>, release_on_clear<double_growth>> vec5(vec1.size());
+    vec1.clear();
+    vec5.clear();
+    os << "retained: " << vec1.capacity() << ", released: " << vec5.capacity() << endl;
+
+    os << "\n3. a vector grown in place by malloc_allocator (mapped from 64 KiB)" << endl;
+    vector<long long, malloc_allocator<long long, 65536>> vec6;
+    for (long long i = 0; i < 1000000; ++i) {
+        vec6.push_back(i);
+    }
+    long long sum = 0;
+    for (auto itr = vec6.begin(); itr != vec6.end(); ++itr) {
+        sum += *itr;
+    }
+    os << "size: " << vec6.size() << ", capacity: " << vec6.capacity() << ", sum: " << sum << endl;
+}
+
+void test_alignment(ostream& os) {
+    using mtl::aligned_allocator;
+    using mtl::huge_page_allocator;
+
+    os << "1. the arrays of a vector<float> aligned to 64 bytes while it grows" << endl;
+    vector<float, aligned_allocator<float, 64>> vec1;
+    for (int i = 0; i < 1000; ++i) {
+        vec1.push_back(static_cast<float>(i));
+        if ((i & (i - 1)) == 0 && i >= 64) {
+            os << "capacity: " << vec1.capacity() << ", aligned: "
+               << (reinterpret_cast<std::uintptr_t>(&vec1.front()) % 64 == 0) << endl;
+        }
+    }
+
+    os << "\n2. a vector backed by huge pages from 64 KiB" << endl;
+    vector<int, huge_page_allocator<int, 65536>> vec2;
+    bool aligned = true;
+    for (int i = 0; i < 1000000; ++i) {
+        vec2.push_back(i);
+        aligned = aligned && reinterpret_cast<std::uintptr_t>(&vec2.front()) % 64 == 0;
+    }
+    long long sum = 0;
+    for (auto itr = vec2.begin(); itr != vec2.end(); ++itr) {
+        sum += *itr;
+    }
+    os << "size: " << vec2.size() << ", capacity: " << vec2.capacity() << ", sum: " << sum
+       << ", aligned: " << aligned << endl;
+}
+
+void test_reserve_resize(ostream& os) {
+    typedef vector<int, counting_allocator<int>> counted_vector;
+
+    os << "1. reserve 1000 cells and push back 1000 numbers" << endl;
+    std::size_t before = allocation_stats::allocations;
+    counted_vector vec1;
+    vec1.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        vec1.push_back(i);
+    }
+    os << "size: " << vec1.size() << ", capacity: " << vec1.capacity()
+       << ", allocations: " << allocation_stats::allocations - before << endl;
+
+    os << "\n2. resize to 5, 8 (value-initialized) and 10 (copies of 7)" << endl;
+    vec1.resize(5);
+    vec1.resize(8);
+    vec1.resize(10, 7);
+    print_vector(os, vec1);
+
+    os << "\n3. shrink_to_fit" << endl;
+    vec1.shrink_to_fit();
+    print_vector(os, vec1);
+
+    os << "\n4. resize an empty vector to 300 default-initialized numbers and fill them" << endl;
+    before = allocation_stats::allocations;
+    counted_vector vec2;
+    vec2.resize(300, default_init);
+    for (std::size_t i = 0; i < vec2.size(); ++i) {
+        vec2[i] = static_cast<int>(i * i);
+    }
+    os << "size: " << vec2.size() << ", capacity: " << vec2.capacity() << ", last: " << vec2.back()
+       << ", allocations: " << allocation_stats::allocations - before << endl;
+
+    os << "\n5. emplace strings at the back, the front and the middle" << endl;
+    vector<std::string> vec3;
+    vec3.emplace_back(3, 'a');
+    vec3.emplace_back("bb");
+    vec3.emplace(vec3.begin(), 2, 'c');
+    vec3.emplace(vec3.begin() + 1, vec3.back());
+    vec3.emplace(vec3.end(), "end");
+    print_vector(os, vec3);
+
+    os << "\n6. shrink_to_fit an empty vector" << endl;
+    vec3.clear();
+    vec3.shrink_to_fit();
+    print_vector(os, vec3);
+}
+
+void test_insert_range(ostream& os) {
+    os << "1. insert a std::vector, an array and a list into the middle" << endl;
+    vector<int> vec1({0, 1, 2, 3});
+    std::vector<int> source1({10, 11, 12});
+    int source2[] = {20, 21};
+    mtl::list<int> source3;
+    source3.push_back(30);
+    source3.push_back(31);
+    vec1.insert_range(vec1.begin() + 2, source1);
+    vec1.insert_range(vec1.begin(), source2);
+    auto itr = vec1.insert_range(vec1.end() - 1, source3);
+    print_vector(os, vec1);
+    os << "the element after the list: " << *itr << endl;
+
+    os << "\n2. append 1000 numbers with one allocation" << endl;
+    std::vector<int> source4(1000, 1);
+    vector<int, counting_allocator<int>> vec2;
+    std::size_t before = allocation_stats::allocations;
+    vec2.append_range(source4);
+    os << "size: " << vec2.size() << ", capacity: " << vec2.capacity()
+       << ", allocations: " << allocation_stats::allocations - before << endl;
+
+    os << "\n3. move the strings of an rvalue vector" << endl;
+    vector<std::string> vec3({"a", "d"});
+    vector<std::string> source5({"b", "c"});
+    vec3.insert_range(vec3.begin() + 1, std::move(source5));
+    print_vector(os, vec3);
+    os << "the moved strings are empty: " << (source5[0].empty() && source5[1].empty()) << endl;
+
+    os << "\n4. a copy throwing in the middle of the range leaves the vector unchanged" << endl;
+    struct throwing {
+        int value;
+        throwing(int v) : value(v) {}
+        throwing(const throwing& t) : value(t.value) {
+            if (value < 0) {
+                throw std::runtime_error("negative");
+            }
+        }
+        throwing(throwing&&) = default;
+        throwing& operator=(const throwing&) = default;
+    };
+    vector<throwing> vec4;
+    for (int i = 0; i < 4; ++i) {
+        vec4.emplace_back(i);
+    }
+    std::vector<throwing> source6;
+    source6.reserve(3);
+    source6.emplace_back(7);
+    source6.emplace_back(8);
+    source6.emplace_back(-1);
+    try {
+        vec4.insert_range(vec4.begin() + 1, source6);
+    } catch (std::runtime_error& e) {
+        os << "caught: " << e.what() << endl;
+    }
+    os << "size: " << vec4.size() << ", elements: ";
+    for (auto i = vec4.begin(); i != vec4.end(); ++i) {
+        os << (*i).value << ", ";
+    }
+    os << endl;
+
+    os << "\n5. a copy constructor throwing in the middle frees the copies made so far" << endl;
+    vector<throwing, counting_allocator<throwing>> vec5;
+    vec5.emplace_back(1);
+    vec5.emplace_back(2);
+    vec5.emplace_back(-1);
+    size_t live_bytes = allocation_stats::live_bytes;
+    try {
+        vector<throwing, counting_allocator<throwing>> copy(vec5);
+    } catch (std::runtime_error& e) {
+        os << "caught: " << e.what() << endl;
+    }
+    os << "no array is leaked: " << (allocation_stats::live_bytes == live_bytes) << endl;
+}
+
+void test_view(ostream& os) {
+    vector<int> vec;
+    for (int i = 0; i < 20; ++i) {
+        vec.push_back((i * 7) % 20);
+    }
+
+    os << "1. a view of the whole vector and a subview [5, 15)" << endl;
+    vector_view<int> all = vec.view();
+    vector_view<int> middle = all.subview(5, 15);
+    print(os, all);
+    print(os, middle);
+    os << "same array: " << (&middle[0] == &vec[5]) << endl;
+
+    os << "\n2. sort the subview in place" << endl;
+    mtl::inplace_quicksort(middle.begin(), middle.end());
+    print_vector(os, vec);
+
+    os << "\n3. a const view and its subviews" << endl;
+    const vector<int>& cvec = vec;
+    vector_view<const int> cview = cvec.view();
+    vector_view<const int> tail = middle.subview(8);
+    os << "size: " << cview.size() << ", front: " << cview.front() << ", back: " << cview.back() << endl;
+    print(os, tail);
+    print(os, tail.subview(1, 1));
+
+    os << "\n4. a subview out of range" << endl;
+    try {
+        middle.subview(3, 11);
+    } catch (std::out_of_range& e) {
+        os << e.what() << endl;
+    }
+}
+
+void test_cow(ostream& os) {
+    typedef cow_vector<int, counting_allocator<int>> counted_cow_vector;
+
+    os << "1. build a cow_vector of 1000 numbers" << endl;
+    counted_cow_vector vec1;
+    vec1.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        vec1.push_back(i);
+    }
+    os << "size: " << vec1.size() << ", use count: " << vec1.use_count() << endl;
+
+    os << "\n2. take 10 snapshots" << endl;
+    std::size_t before = allocation_stats::allocations;
+    std::vector<counted_cow_vector> snapshots(10, vec1);
+    os << "use count: " << vec1.use_count() << ", allocations: " << allocation_stats::allocations - before
+       << ", same array: " << (&snapshots[9][0] == &vec1[0]) << endl;
+
+    os << "\n3. modify the original, only it is duplicated" << endl;
+    before = allocation_stats::allocations;
+    vec1.set(0, -1);
+    vec1.push_back(1000);
+    os << "original: " << vec1[0] << ", " << vec1.size() << " elements, use count " << vec1.use_count() << endl;
+    os << "snapshot: " << snapshots[0][0] << ", " << snapshots[0].size() << " elements, use count "
+       << snapshots[0].use_count() << endl;
+    os << "allocations: " << allocation_stats::allocations - before << endl;
+
+    os << "\n4. clear a snapshot and edit another one" << endl;
+    snapshots[1].clear();
+    snapshots[2].edit().remove(snapshots[2].edit().begin() + 1, snapshots[2].edit().end());
+    print(os, snapshots[1]);
+    print(os, snapshots[2]);
+    os << "use count of the others: " << snapshots[0].use_count() << endl;
+
+    os << "\n5. drop everything" << endl;
+    snapshots.clear();
+    vec1 = counted_cow_vector();
+    os << "live bytes: " << allocation_stats::live_bytes << endl;
+
+    os << "\n6. move between the allocators of different pools, it may allocate so it isn't noexcept" << endl;
+    typedef cow_vector<int, pool_allocator<int>> pool_cow_vector;
+    pool_cow_vector vec2({1, 2, 3}, pool_allocator<int>(1));
+    pool_cow_vector vec3(pool_allocator<int>(2));
+    vec3 = std::move(vec2);
+    print(os, vec3);
+    os << "pool: " << vec3.get_allocator().pool << ", the moved one is empty: " << vec2.empty() << endl;
+    os << "noexcept: " << std::is_nothrow_move_assignable<pool_cow_vector>::value
+       << ", with counting_allocator: " << std::is_nothrow_move_assignable<counted_cow_vector>::value << endl;
+
+    os << "\n7. move a shared one between the pools, its other copies keep their elements" << endl;
+    typedef cow_vector<std::string, pool_allocator<std::string>> pool_cow_strings;
+    pool_cow_strings strs1({"first", "second"}, pool_allocator<std::string>(1));
+    pool_cow_strings strs2 = strs1;
+    pool_cow_strings strs3(pool_allocator<std::string>(2));
+    strs3 = std::move(strs1);
+    print(os, strs2);
+    print(os, strs3);
+    os << "the moved one is empty: " << strs1.empty() << ", use count of the copy: " << strs2.use_count() << endl;
+}
+
+void test_remove_if(ostream& os) {
+    os << "1. remove the odd numbers" << endl;
+    vector<int> vec1;
+    for (int i = 0; i < 20; ++i) {
+        vec1.push_back(i);
+    }
+    size_t removed = vec1.remove_if([](int x) { return x % 2 == 1; });
+    os << "removed: " << removed << endl;
+    print_vector(os, vec1);
+    os << "removed nothing: " << vec1.remove_if([](int x) { return x > 100; }) << endl;
+
+    os << "\n2. remove strings, the order is kept" << endl;
+    vector<std::string> vec2({"apple", "x", "banana", "y", "z", "cherry"});
+    vec2.remove_if([](const std::string& s) { return s.size() == 1; });
+    print_vector(os, vec2);
+
+    os << "\n3. remove by sorted indices, the duplicates and the ones out of range are ignored" << endl;
+    vector<int> vec3({0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+    std::vector<size_t> indices({0, 3, 3, 4, 9, 12});
+    os << "removed: " << vec3.remove_indices(indices) << endl;
+    print_vector(os, vec3);
+    vector<std::string> vec4({"a", "b", "c", "d"});
+    size_t strs[] = {1, 2};
+    vec4.remove_indices(strs);
+    print_vector(os, vec4);
+
+    os << "\n4. a throwing predicate keeps the elements not examined yet" << endl;
+    vector<std::string> vec5({"a", "bb", "c", "throw", "d", "ee"});
+    try {
+        vec5.remove_if([](const std::string& s) {
+            if (s == "throw") {
+                throw std::runtime_error("bad element");
+            }
+            return s.size() == 1;
+        });
+    } catch (std::runtime_error& e) {
+        os << "caught: " << e.what() << endl;
+    }
+    print_vector(os, vec5);
+    vector<int> vec6({1, 2, 3, 4, 5});
+    try {
+        vec6.remove_if([](int x) {
+            if (x == 4) {
+                throw std::runtime_error("bad number");
+            }
+            return x == 2;
+        });
+    } catch (std::runtime_error& e) {
+        os << "caught: " << e.what() << endl;
+    }
+    print_vector(os, vec6);
+
+    os << "\n5. remove every third of 1000000 numbers" << endl;
+    vector<int> vec7;
+    for (int i = 0; i < 1000000; ++i) {
+        vec7.push_back(i);
+    }
+    vec7.remove_if([](int x) { return x % 3 == 0; });
+    bool ordered = true;
+    for (size_t i = 1; i < vec7.size(); ++i) {
+        ordered = ordered && vec7[i - 1] < vec7[i] && vec7[i] % 3 != 0;
+    }
+    os << "size: " << vec7.size() << ", ordered: " << (ordered ? "yes" : "no") << endl;
+}
+
 int main() {
     ofstream ofs1("test_constructor.txt");
     test_constructor(ofs1);
@@ -143,5 +542,29 @@ int main() {
     ofstream ofs4("test_insert_remove.txt");
     test_insert_remove(ofs4);
 
+    ofstream ofs5("test_allocator.txt");
+    test_allocator(ofs5);
+
+    ofstream ofs6("test_growth.txt");
+    test_growth(ofs6);
+
+    ofstream ofs7("test_alignment.txt");
+    test_alignment(ofs7);
+
+    ofstream ofs8("test_reserve_resize.txt");
+    test_reserve_resize(ofs8);
+
+    ofstream ofs9("test_insert_range.txt");
+    test_insert_range(ofs9);
+
+    ofstream ofs10("test_view.txt");
+    test_view(ofs10);
+
+    ofstream ofs11("test_cow.txt");
+    test_cow(ofs11);
+
+    ofstream ofs12("test_remove_if.txt");
+    test_remove_if(ofs12);
+
     return 0;
 }
\ No newline at end of file